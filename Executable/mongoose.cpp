@@ -5,42 +5,188 @@
 #include "Mongoose_Logger.hpp"
 #include "Mongoose_Version.hpp"
 
+#include <chrono>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
 
 using namespace Mongoose;
 
+/* Formats for the partition written after the JSON block */
+enum OutputFormat
+{
+    Output_Text,    // "vertex part" on each line
+    Output_Compact, // "part" on each line
+    Output_Binary,  // one byte (0 or 1) per vertex
+    Output_Bitset   // one bit per vertex, least significant bit first
+};
+
+/* Write the decimal digits of k at end, returning the new end */
+char *formatInt(char *end, Int k)
+{
+    char digits[24];
+    int d = 0;
+    do
+    {
+        digits[d++] = (char)('0' + k % 10);
+        k /= 10;
+    } while (k > 0);
+    while (d > 0)
+        *end++ = digits[--d];
+    return end;
+}
+
+/* Write the partition through a fixed buffer, in large blocks */
+void writePartition(std::ofstream &ofs, const EdgeCut *result,
+                    OutputFormat format)
+{
+    const size_t bufferSize = 1 << 20;
+    const size_t maxLine    = 32; // longest text line, with room to spare
+    char *buffer            = new char[bufferSize];
+    char *end               = buffer;
+
+    const bool *partition = result->partition;
+    for (Int i = 0; i < result->n; i++)
+    {
+        switch (format)
+        {
+        case Output_Text:
+            end    = formatInt(end, i);
+            *end++ = ' ';
+            *end++ = (partition[i]) ? '1' : '0';
+            *end++ = '\n';
+            break;
+        case Output_Compact:
+            *end++ = (partition[i]) ? '1' : '0';
+            *end++ = '\n';
+            break;
+        case Output_Binary:
+            *end++ = (partition[i]) ? 1 : 0;
+            break;
+        case Output_Bitset:
+            if (i % 8 == 0)
+                *end++ = 0;
+            end[-1] |= (char)((partition[i]) ? (1 << (i % 8)) : 0);
+            break;
+        }
+
+        // Only flush on a byte boundary so a bitset byte is never split
+        if (static_cast<size_t>(end - buffer) > bufferSize - 8 * maxLine
+            && (i + 1) % 8 == 0)
+        {
+            ofs.write(buffer, end - buffer);
+            end = buffer;
+        }
+    }
+    ofs.write(buffer, end - buffer);
+
+    delete[] buffer;
+}
+
+/* Write the hardware counts of one phase as a JSON object, at one coarsening
+   level or (if level < 0) over all levels; unavailable counters are -1 */
+void writeCounters(std::ofstream &ofs, TimingType timingType, Int level)
+{
+    static const char *names[PerfCounters::NumCounters]
+        = { "Cycles", "Instructions", "LLCMisses", "BranchMisses",
+            "DTLBMisses" };
+    ofs << "{ ";
+    for (int c = 0; c < PerfCounters::NumCounters; c++)
+    {
+        PerfCounterType counter = (PerfCounterType)c;
+        double count = (level < 0) ? get_perf_counter(timingType, counter)
+                                   : get_perf_counter(timingType, counter, level);
+        ofs << ((c > 0) ? ", " : "") << "\"" << names[c]
+            << "\": " << std::setprecision(15) << count;
+    }
+    ofs << " }" << std::setprecision(6);
+}
+
 int main(int argn, const char **argv)
 {
     SuiteSparse_start();
 
-    clock_t t;
+    std::chrono::steady_clock::time_point start;
     
     // Set Logger to report only Error messages
     Logger::setDebugLevel(Error);
 
-    if (argn < 2 || argn > 3)
+    // Read in input and output file names, and the output format
+    std::string inputFile;
+    std::string outputFile = "mongoose_out.txt";
+    OutputFormat format    = Output_Text;
+    bool statistics        = false;
+    bool counters          = false;
+    bool memory            = false;
+    std::string traceFile;
+    int files              = 0;
+    bool usageError        = false;
+    for (int k = 1; k < argn && !usageError; k++)
     {
-        // Wrong number of arguments - return error
-        LogError("Usage: mongoose <MM-input-file.mtx> [output-file]");
-        SuiteSparse_finish();
-        return EXIT_FAILURE;
+        if (strcmp(argv[k], "-f") == 0 && k + 1 < argn)
+        {
+            k++;
+            if (strcmp(argv[k], "text") == 0)
+                format = Output_Text;
+            else if (strcmp(argv[k], "compact") == 0)
+                format = Output_Compact;
+            else if (strcmp(argv[k], "binary") == 0)
+                format = Output_Binary;
+            else if (strcmp(argv[k], "bitset") == 0)
+                format = Output_Bitset;
+            else
+                usageError = true;
+        }
+        else if (strcmp(argv[k], "-s") == 0)
+        {
+            statistics = true;
+        }
+        else if (strcmp(argv[k], "--counters") == 0)
+        {
+            counters = true;
+        }
+        else if (strcmp(argv[k], "--memory") == 0)
+        {
+            memory = true;
+        }
+        else if (strcmp(argv[k], "--trace") == 0 && k + 1 < argn)
+        {
+            traceFile = std::string(argv[++k]);
+        }
+        else if (files == 0)
+        {
+            inputFile = std::string(argv[k]);
+            files++;
+        }
+        else if (files == 1)
+        {
+            outputFile = std::string(argv[k]);
+            files++;
+        }
+        else
+        {
+            usageError = true;
+        }
     }
 
-    // Read in input file name
-    std::string inputFile = std::string(argv[1]);
-
-    std::string outputFile;
-    if (argn == 3)
-    {
-        outputFile = std::string(argv[2]);
-    }
-    else
+    if (files == 0 || usageError)
     {
-        outputFile = "mongoose_out.txt";
+        // Wrong arguments - return error
+        LogError("Usage: mongoose <input-file.mtx|.graph> [output-file] "
+                 "[-f text|compact|binary|bitset] [-s] [--trace trace.json] "
+                 "[--counters] [--memory]");
+        SuiteSparse_finish();
+        return EXIT_FAILURE;
     }
 
-    // Turn timing information on
+    // Turn timing information on, and tracing if requested
     Logger::setTimingFlag(true);
+    Trace::setTracingFlag(!traceFile.empty());
+    if (counters && !set_perf_counters(true))
+    {
+        std::cout << "Hardware performance counters are not available\n";
+    }
+    set_memory_accounting(memory);
 
     EdgeCut_Options *options = EdgeCut_Options::create();
     if (!options)
@@ -49,6 +195,7 @@ int main(int argn, const char **argv)
         LogError("Error creating Options struct");
         return EXIT_FAILURE;
     }
+    options->collect_statistics = statistics;
 
     Graph *graph = read_graph(inputFile);
 
@@ -72,9 +219,11 @@ int main(int argn, const char **argv)
     std::cout << "********************************************************************************" << std::endl;
 
     // An edge separator should be computed with default options
-    t = clock();
+    start = std::chrono::steady_clock::now();
     EdgeCut *result = edge_cut(graph, options);
-    t = clock() - t;
+    double test_time = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
 
     if (!result)
     {
@@ -87,19 +236,48 @@ int main(int argn, const char **argv)
     }
     else
     {
-        double test_time = ((double) t)/CLOCKS_PER_SEC;
         std::cout << "Total Edge Separator Time: " << test_time << "s\n";
         Logger::printTimingInfo();
         std::cout << "Cut Properties:\n";
         std::cout << " Cut Size:       " << result->cut_size << "\n";
         std::cout << " Cut Cost:       " << result->cut_cost << "\n";
         std::cout << " Imbalance:      " << result->imbalance << "\n";
+        std::cout << " GradProj Its:   " << result->gradproj_iterations << "\n";
+        if (result->levels)
+        {
+            std::cout << "Level Statistics:\n";
+            std::cout << " Level        n       nz  Ratio   Orphan Standard"
+                         " Brotherly Community    Cut In  After FM  After QP"
+                         "  FM Kept  FM Undone  QP Its  QP Residual"
+                         "   Peak Memory\n";
+            for (Int l = 0; l < result->num_levels; l++)
+            {
+                const EdgeCut_Level &s = result->levels[l];
+                std::cout << std::setw(6) << l << std::setw(9) << s.n
+                          << std::setw(9) << s.nz << std::setw(7)
+                          << std::setprecision(3) << s.coarsening_ratio
+                          << std::setw(9) << s.orphan_matches << std::setw(9)
+                          << s.standard_matches << std::setw(10)
+                          << s.brotherly_matches << std::setw(10)
+                          << s.community_matches << std::setw(10)
+                          << std::setprecision(6) << s.cut_before_FM
+                          << std::setw(10) << s.cut_after_FM << std::setw(10)
+                          << s.cut_after_QP << std::setw(9) << s.FM_moves
+                          << std::setw(11) << s.FM_moves_undone << std::setw(8)
+                          << s.QP_iterations << std::setw(13)
+                          << std::setprecision(3) << s.QP_residual
+                          << std::setw(14) << s.peak_memory << "\n";
+            }
+        }
 
         // Write results to file
         if (!outputFile.empty())
         {
             LogTest("Writing results to file: " << outputFile);
-            std::ofstream ofs (outputFile.c_str(), std::ofstream::out);
+            bool text = (format == Output_Text || format == Output_Compact);
+            std::ofstream ofs(outputFile.c_str(),
+                              (text) ? std::ofstream::out
+                                     : std::ofstream::out | std::ofstream::binary);
             ofs << "{" << std::endl;
             ofs << "  \"InputFile\": \"" << inputFile << "\"," << std::endl;
             ofs << "  \"Timing\": {" << std::endl;
@@ -109,24 +287,116 @@ int main(int argn, const char **argv)
             ofs << "    \"Refinement\": " << Logger::getTime(RefinementTiming) << "," << std::endl;
             ofs << "    \"FM\": " << Logger::getTime(FMTiming) << "," << std::endl;
             ofs << "    \"QP\": " << Logger::getTime(QPTiming) << "," << std::endl;
-            ofs << "    \"IO\": " << Logger::getTime(IOTiming) << std::endl;
+            ofs << "    \"IO\": " << Logger::getTime(IOTiming) << "," << std::endl;
+            ofs << "    \"Sanitize\": " << Logger::getTime(SanitizeTiming) << "," << std::endl;
+            ofs << "    \"GuessCut\": " << Logger::getTime(GuessCutTiming) << "," << std::endl;
+            ofs << "    \"Levels\": [" << std::endl;
+            for (Int l = 0; l < Logger::getTimingLevels(); l++)
+            {
+                ofs << "      { \"Matching\": " << Logger::getTime(MatchingTiming, l)
+                    << ", \"Coarsening\": " << Logger::getTime(CoarseningTiming, l)
+                    << ", \"Refinement\": " << Logger::getTime(RefinementTiming, l)
+                    << ", \"FM\": " << Logger::getTime(FMTiming, l)
+                    << ", \"QP\": " << Logger::getTime(QPTiming, l)
+                    << ", \"GuessCut\": " << Logger::getTime(GuessCutTiming, l)
+                    << " }" << ((l + 1 < Logger::getTimingLevels()) ? "," : "")
+                    << std::endl;
+            }
+            ofs << "    ]" << std::endl;
             ofs << "  }," << std::endl;
+            if (counters)
+            {
+                static const TimingType phases[]
+                    = { MatchingTiming, CoarseningTiming, RefinementTiming,
+                        FMTiming,       QPTiming,         GuessCutTiming };
+                static const char *phaseNames[]
+                    = { "Matching", "Coarsening", "Refinement",
+                        "FM",       "QP",         "GuessCut" };
+                const int numPhases = 6;
+                ofs << "  \"Counters\": {" << std::endl;
+                for (int t = 0; t < numPhases; t++)
+                {
+                    ofs << "    \"" << phaseNames[t] << "\": ";
+                    writeCounters(ofs, phases[t], -1);
+                    ofs << "," << std::endl;
+                }
+                ofs << "    \"Levels\": [" << std::endl;
+                for (Int l = 0; l < Logger::getTimingLevels(); l++)
+                {
+                    ofs << "      {" << std::endl;
+                    for (int t = 0; t < numPhases; t++)
+                    {
+                        ofs << "        \"" << phaseNames[t] << "\": ";
+                        writeCounters(ofs, phases[t], l);
+                        ofs << ((t + 1 < numPhases) ? "," : "") << std::endl;
+                    }
+                    ofs << "      }"
+                        << ((l + 1 < Logger::getTimingLevels()) ? "," : "")
+                        << std::endl;
+                }
+                ofs << "    ]" << std::endl;
+                ofs << "  }," << std::endl;
+            }
+            if (memory)
+            {
+                static const TimingType phases[]
+                    = { MatchingTiming, CoarseningTiming, RefinementTiming,
+                        FMTiming,       QPTiming,         GuessCutTiming };
+                static const char *phaseNames[]
+                    = { "Matching", "Coarsening", "Refinement",
+                        "FM",       "QP",         "GuessCut" };
+                const int numPhases = 6;
+                ofs << "  \"Memory\": {" << std::endl;
+                ofs << "    \"Peak\": " << result->peak_memory << ","
+                    << std::endl;
+                for (int t = 0; t < numPhases; t++)
+                {
+                    ofs << "    \"" << phaseNames[t] << "\": { \"Peak\": "
+                        << get_memory_peak(phases[t]) << ", \"Allocated\": "
+                        << get_memory_allocated(phases[t]) << " }," << std::endl;
+                }
+                ofs << "    \"Levels\": [" << std::endl;
+                for (Int l = 0; l < Logger::getTimingLevels(); l++)
+                {
+                    ofs << "      {";
+                    for (int t = 0; t < numPhases; t++)
+                    {
+                        ofs << ((t > 0) ? "," : "") << " \"" << phaseNames[t]
+                            << "\": { \"Peak\": " << get_memory_peak(phases[t], l)
+                            << ", \"Allocated\": "
+                            << get_memory_allocated(phases[t], l) << " }";
+                    }
+                    ofs << " }"
+                        << ((l + 1 < Logger::getTimingLevels()) ? "," : "")
+                        << std::endl;
+                }
+                ofs << "    ]" << std::endl;
+                ofs << "  }," << std::endl;
+            }
             ofs << "  \"CutSize\": " << result->cut_size << "," << std::endl;
             ofs << "  \"CutCost\": " << result->cut_cost << "," << std::endl;
             ofs << "  \"Imbalance\": " << result->imbalance << std::endl;
             ofs << "}" << std::endl;
 
             ofs << std::endl;
-            for (Int i = 0; i < graph->n; i++)
+            writePartition(ofs, result, format);
+            if (text)
             {
-                ofs << i << " " << result->partition[i] << std::endl;
+                ofs << std::endl;
             }
-            ofs << std::endl;
 
             ofs.close();
         }
     }
 
+    // Write the timeline
+    if (!traceFile.empty())
+    {
+        if (Trace::write(traceFile.c_str()))
+            std::cout << "Trace written to " << traceFile << "\n";
+        Trace::clear();
+    }
+
     options->~EdgeCut_Options();
     graph->~Graph();
     result->~EdgeCut();
@@ -39,7 +39,8 @@ enum MatchingStrategy
     Random,
     HEM,
     HEMSR,
-    HEMSRdeg
+    HEMSRdeg,
+    LabelProp
 };
 
 enum InitialEdgeCutType
@@ -49,15 +50,58 @@ enum InitialEdgeCutType
     InitialEdgeCut_NaturalOrder
 };
 
+enum NapsackSolver
+{
+    NapsackSolver_Heap,
+    NapsackSolver_Selection
+};
+
+enum VertexOrdering
+{
+    VertexOrdering_Natural,
+    VertexOrdering_BFS,
+    VertexOrdering_RCM
+};
+
+enum TimingType
+{
+    MatchingTiming,
+    CoarseningTiming,
+    RefinementTiming,
+    FMTiming,
+    QPTiming,
+    IOTiming,
+    SanitizeTiming,
+    GuessCutTiming
+};
+
+enum PerfCounterType
+{
+    CyclesCounter,
+    InstructionsCounter,
+    LLCMissesCounter,
+    BranchMissesCounter,
+    DTLBMissesCounter
+};
+
 struct EdgeCut_Options
 {
     Int random_seed;
+    bool collect_statistics; /* Return per-level statistics with the cut */
+    double memory_limit;     /* Max bytes allocated by a cut (0: no limit) */
 
     /** Coarsening Options ***************************************************/
     Int coarsen_limit;
+    double coarsen_min_shrink; /* Stop coarsening when a level removes less
+                                  than this fraction of the vertices */
+    Int coarsen_max_levels;    /* Max # of coarsening levels (0: no limit)  */
     MatchingStrategy matching_strategy;
     bool do_community_matching;
     double high_degree_threshold;
+    bool component_analysis; /* Partition only the large connected
+                                components; pack the small ones */
+    VertexOrdering vertex_ordering; /* Renumber the graph for locality */
+    bool graph_reduction; /* Fold leaves and merge twins before coarsening */
 
     /** Guess Partitioning Options *******************************************/
     InitialEdgeCutType initial_cut_type; /* The guess cut type to use */
@@ -76,6 +120,10 @@ struct EdgeCut_Options
     bool use_QP_gradproj;         /* Flag governing the use of gradproj       */
     double gradproj_tolerance;   /* Convergence tol for projected gradient   */
     Int gradproj_iteration_limit; /* Max # of iterations for gradproj         */
+    bool gradproj_accelerate;     /* Use Barzilai-Borwein steps in gradproj   */
+    Int QP_band_depth;            /* If > 0, only vertices within this many
+                                     hops of the boundary are free in the QP */
+    NapsackSolver napsack_solver; /* Search used to find the napsack lambda   */
 
     /** Final Partition Target Metrics ***************************************/
     double target_split;        /* The desired split ratio (default 50/50)  */
@@ -113,6 +161,12 @@ private:
     bool shallow_i;
     bool shallow_x;
     bool shallow_w;
+
+    /** Binary file the arrays point into, released with the graph **********/
+    void *mapping;
+    size_t mappingSize;
+
+    friend Graph *read_graph_binary(const char *filename);
 };
 
 /**
@@ -120,9 +174,12 @@ private:
  *
  * Generate a Graph class instance from a Matrix Market file. The matrix
  * contained in the file must be sparse, real, and square. If the matrix
- * is not symmetric, it will be made symmetric with (A+A')/2. If the matrix has
- * more than one connected component, the largest will be found and the rest
- * discarded. If a diagonal is present, it will be removed.
+ * is not symmetric, it will be made symmetric with (A+A')/2. All connected
+ * components are kept (see EdgeCut_Options::component_analysis for handling
+ * disconnected graphs). If a diagonal is present, it will be removed. A
+ * binary graph file (see write_graph_binary) is also accepted, and is loaded
+ * with read_graph_binary, as is a METIS graph file ending in ".graph", which is
+ * loaded with read_graph_metis.
  *
  * @param filename the filename or path to the Matrix Market File.
  */
@@ -133,14 +190,201 @@ Graph *read_graph(const std::string &filename);
  *
  * Generate a Graph class instance from a Matrix Market file. The matrix
  * contained in the file must be sparse, real, and square. If the matrix
- * is not symmetric, it will be made symmetric with (A+A')/2. If the matrix has
- * more than one connected component, the largest will be found and the rest
- * discarded. If a diagonal is present, it will be removed.
+ * is not symmetric, it will be made symmetric with (A+A')/2. All connected
+ * components are kept (see EdgeCut_Options::component_analysis for handling
+ * disconnected graphs). If a diagonal is present, it will be removed. A
+ * binary graph file (see write_graph_binary) is also accepted, and is loaded
+ * with read_graph_binary, as is a METIS graph file ending in ".graph", which is
+ * loaded with read_graph_metis.
  *
  * @param filename the filename or path to the Matrix Market File.
  */
 Graph *read_graph(const char *filename);
 
+/**
+ * Generate a Graph from a Matrix Market file, using a cache.
+ *
+ * If use_cache is true, the sanitized graph is saved as a binary graph file
+ * named filename.mgb next to the Matrix Market file, together with a hash of
+ * the Matrix Market file. Later calls with use_cache set load the cache with
+ * read_graph_binary instead of parsing and sanitizing the file again. The
+ * cache is rebuilt if the hash no longer matches. A cache that cannot be
+ * written is not an error. If use_cache is false, this is the same as
+ * read_graph(filename).
+ *
+ * @param filename the filename or path to the Matrix Market File.
+ * @param use_cache whether to read and write the cache.
+ */
+Graph *read_graph(const std::string &filename, bool use_cache);
+
+/**
+ * Generate a Graph from a Matrix Market file, using a cache.
+ *
+ * If use_cache is true, the sanitized graph is saved as a binary graph file
+ * named filename.mgb next to the Matrix Market file, together with a hash of
+ * the Matrix Market file. Later calls with use_cache set load the cache with
+ * read_graph_binary instead of parsing and sanitizing the file again. The
+ * cache is rebuilt if the hash no longer matches. A cache that cannot be
+ * written is not an error. If use_cache is false, this is the same as
+ * read_graph(filename).
+ *
+ * @param filename the filename or path to the Matrix Market File.
+ * @param use_cache whether to read and write the cache.
+ */
+Graph *read_graph(const char *filename, bool use_cache);
+
+/**
+ * Generate a Graph from a Matrix Market file using bounded memory.
+ *
+ * Gives the same graph as read_graph, but builds it in two passes over the
+ * file instead of holding the triplets, the compressed matrix and the
+ * sanitized copies at once. The first pass counts the entries of each
+ * vertex of (A+A')/2, and the second places them directly in the Graph,
+ * dropping the diagonal. Duplicate edges are then summed in place. Peak
+ * memory is the size of the Graph plus work space the size of the largest
+ * adjacency list. A symmetric pattern matrix gives a Graph without edge
+ * weights.
+ *
+ * @param filename the filename or path to the Matrix Market File.
+ */
+Graph *read_graph_streaming(const std::string &filename);
+
+/**
+ * Generate a Graph from a Matrix Market file using bounded memory.
+ *
+ * Gives the same graph as read_graph, but builds it in two passes over the
+ * file instead of holding the triplets, the compressed matrix and the
+ * sanitized copies at once. The first pass counts the entries of each
+ * vertex of (A+A')/2, and the second places them directly in the Graph,
+ * dropping the diagonal. Duplicate edges are then summed in place. Peak
+ * memory is the size of the Graph plus work space the size of the largest
+ * adjacency list. A symmetric pattern matrix gives a Graph without edge
+ * weights.
+ *
+ * @param filename the filename or path to the Matrix Market File.
+ */
+Graph *read_graph_streaming(const char *filename);
+
+/**
+ * Generate a Graph from a METIS or Chaco graph file.
+ *
+ * The file holds the adjacency list of each vertex on its own line, after
+ * a header line "n m [fmt [ncon]]" giving the number of vertices and edges.
+ * fmt selects vertex sizes (ignored), vertex weights and edge weights, as in
+ * METIS; only one vertex weight per vertex (ncon = 1) is supported. Lines
+ * starting with '%' are comments. The Graph is built directly from the
+ * adjacency lists. Only if the file does not hold 2m entries or has
+ * self-edges is it sanitized as a Matrix Market file would be.
+ *
+ * @param filename the filename or path of the METIS graph file.
+ */
+Graph *read_graph_metis(const std::string &filename);
+
+/**
+ * Generate a Graph from a METIS or Chaco graph file.
+ *
+ * The file holds the adjacency list of each vertex on its own line, after
+ * a header line "n m [fmt [ncon]]" giving the number of vertices and edges.
+ * fmt selects vertex sizes (ignored), vertex weights and edge weights, as in
+ * METIS; only one vertex weight per vertex (ncon = 1) is supported. Lines
+ * starting with '%' are comments. The Graph is built directly from the
+ * adjacency lists. Only if the file does not hold 2m entries or has
+ * self-edges is it sanitized as a Matrix Market file would be.
+ *
+ * @param filename the filename or path of the METIS graph file.
+ */
+Graph *read_graph_metis(const char *filename);
+
+/**
+ * Write a Graph to a binary graph file.
+ *
+ * The graph is written as is, so it should already be sanitized (as it is
+ * when returned by read_graph).
+ *
+ * @param graph the graph to write.
+ * @param filename the filename or path of the binary graph file.
+ * @return true on success, false if the file could not be written.
+ */
+bool write_graph_binary(const Graph *graph, const std::string &filename);
+
+/**
+ * Write a Graph to a binary graph file.
+ *
+ * The graph is written as is, so it should already be sanitized (as it is
+ * when returned by read_graph).
+ *
+ * @param graph the graph to write.
+ * @param filename the filename or path of the binary graph file.
+ * @return true on success, false if the file could not be written.
+ */
+bool write_graph_binary(const Graph *graph, const char *filename);
+
+/**
+ * Generate a Graph from a binary graph file.
+ *
+ * Where supported, the file is memory-mapped and the Graph points directly
+ * into the mapping, which is released when the Graph is destroyed. Pages are
+ * mapped copy-on-write, so changes to the Graph are never written back.
+ * Otherwise, the file is read into memory in one piece. The column pointers
+ * must be nondecreasing from p[0] = 0 to p[n] = nz and the row indices lie
+ * in [0, n), or the file is rejected; the weights are not checked.
+ *
+ * @param filename the filename or path of the binary graph file.
+ */
+Graph *read_graph_binary(const std::string &filename);
+
+/**
+ * Generate a Graph from a binary graph file.
+ *
+ * Where supported, the file is memory-mapped and the Graph points directly
+ * into the mapping, which is released when the Graph is destroyed. Pages are
+ * mapped copy-on-write, so changes to the Graph are never written back.
+ * Otherwise, the file is read into memory in one piece. The column pointers
+ * must be nondecreasing from p[0] = 0 to p[n] = nz and the row indices lie
+ * in [0, n), or the file is rejected; the weights are not checked.
+ *
+ * @param filename the filename or path of the binary graph file.
+ */
+Graph *read_graph_binary(const char *filename);
+
+/* Synthetic graphs, built directly from a size and a seed (the same arguments
+   always give the same graph). They are symmetric, with no self-edges, and
+   unit edge and vertex weights. generate_graph takes a specification
+   "kind:size[:seed]", with kind one of grid2d, grid3d, mesh2d, mesh3d,
+   geometric, er, or rmat. */
+Graph *generate_grid(Int nx, Int ny, Int nz = 1);
+Graph *generate_mesh(Int nx, Int ny, Int nz = 1);
+Graph *generate_geometric(Int n, double degree, Int seed);
+Graph *generate_rmat(Int scale, Int edgeFactor, Int seed);
+Graph *generate_erdos_renyi(Int n, double degree, Int seed);
+Graph *generate_graph(const std::string &spec);
+Graph *generate_graph(const char *spec);
+
+struct EdgeCut_Level
+{
+    Int n;                   /** # vertices                            */
+    Int nz;                  /** # nonzeros in the adjacency matrix    */
+    double coarsening_ratio; /** n / n of the next finer level         */
+
+    /** Matching, by match type, of the vertices of this level ***********/
+    Int orphan_matches;
+    Int standard_matches;
+    Int brotherly_matches;
+    Int community_matches;
+
+    /** Refinement, in the last dance at this level **********************/
+    double cut_before_FM; /** Cut cost projected from the coarser level */
+    double cut_after_FM;  /** Cut cost after FM                         */
+    double cut_after_QP;  /** Cut cost after QP                         */
+    Int FM_moves;         /** # FM moves kept (all dances)              */
+    Int FM_moves_undone;  /** # FM moves rolled back (all dances)       */
+    Int QP_iterations;    /** # gradproj iterations (all dances)        */
+    double QP_residual;   /** Residual of the last gradproj run         */
+
+    /** Memory, while accounting is on (see set_memory_accounting) *******/
+    Int peak_memory; /** Peak bytes allocated at this level, or -1       */
+};
+
 struct EdgeCut
 {
     bool *partition;     /** T/F denoting partition side     */
@@ -155,6 +399,18 @@ struct EdgeCut
                             is imbalanced, and this is
                             computed as (0.5 - W0/W).         */
 
+    /** Solver Statistics ****************************************************/
+    Int gradproj_iterations; /** Total # of gradient projection
+                                 iterations over all levels       */
+
+    /** Multilevel Statistics ************************************************/
+    EdgeCut_Level *levels; /** One entry per level, from the input graph
+                               (0) to the coarsest, or NULL unless
+                               collect_statistics is set          */
+    Int num_levels;        /** # entries in levels                */
+    Int peak_memory;       /** Peak bytes allocated by edge_cut, or
+                               -1 if memory accounting was off    */
+
     // desctructor (no constructor)
     ~EdgeCut();
 };
@@ -162,6 +418,65 @@ struct EdgeCut
 EdgeCut *edge_cut(const Graph *);
 EdgeCut *edge_cut(const Graph *, const EdgeCut_Options *);
 
+/* Timing information, in seconds of wall clock time. Timings are kept
+   separately for each thread and accumulate until reset_timing is called.
+   get_timing(type, level) gives the time spent at one coarsening level
+   (0 is the input graph), for get_timing_levels() levels. */
+void set_timing(bool enabled);
+void reset_timing();
+double get_timing(TimingType timingType);
+double get_timing(TimingType timingType, Int level);
+Int get_timing_levels();
+
+/* Timeline tracing. While tracing is on, the beginning and end of each phase
+   of the library are recorded, with the coarsening level, thread, and problem
+   size. write_trace writes the events recorded so far as a Chrome trace
+   (JSON), viewable in chrome://tracing or Perfetto; clear_trace discards
+   them. */
+void set_tracing(bool enabled);
+bool write_trace(const std::string &filename);
+bool write_trace(const char *filename);
+void clear_trace();
+
+/* Hardware performance counters (Linux only). While counting is on, cycles,
+   instructions, last-level cache misses, branch misses and dTLB misses are
+   counted for each timed phase and coarsening level, on the calling thread,
+   until reset_timing is called. set_perf_counters returns false if no
+   counter is available (e.g. in a virtual machine without a PMU), and
+   get_perf_counter returns -1 for a counter that is not available. */
+bool set_perf_counters(bool enabled);
+double get_perf_counter(TimingType timingType, PerfCounterType counter);
+double get_perf_counter(TimingType timingType, PerfCounterType counter,
+                        Int level);
+
+/* Memory accounting. While accounting is on, the bytes allocated by Mongoose
+   on the calling thread are counted: the bytes in use, their peak, and for
+   each timed phase and coarsening level, the peak bytes in use while the
+   phase ran and the bytes it allocated, until reset_timing is called.
+   Turning accounting off forgets the bytes in use. With
+   collect_statistics set, edge_cut turns accounting on for its duration. */
+void set_memory_accounting(bool enabled);
+Int get_memory_in_use();
+Int get_memory_peak();
+Int get_memory_peak(TimingType timingType);
+Int get_memory_peak(TimingType timingType, Int level);
+Int get_memory_allocated(TimingType timingType);
+Int get_memory_allocated(TimingType timingType, Int level);
+
+/* Memory management. The arrays Mongoose hands to the caller (those of a
+   Graph it creates or reads, and of an EdgeCut) are allocated with
+   mongoose_malloc or mongoose_calloc, which keep the size of each block in
+   a header for memory accounting. Such an array must be freed with
+   mongoose_free, never with SuiteSparse_free or free, and an array the
+   caller stores in a Graph that frees it (one of the arrays Graph::create
+   allocated) must be allocated with mongoose_malloc or mongoose_calloc.
+   The arguments are those of the SuiteSparse_config functions. */
+void *mongoose_malloc(size_t nitems, size_t size_of_item);
+void *mongoose_calloc(size_t nitems, size_t size_of_item);
+void *mongoose_realloc(size_t nitems_new, size_t nitems_old,
+                       size_t size_of_item, void *p, int *ok);
+void *mongoose_free(void *p);
+
 /* Version information */
 int major_version();
 int minor_version();
@@ -0,0 +1,38 @@
+/* ========================================================================== */
+/* === Include/Mongoose_Components.hpp ====================================== */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+/**
+ * Connected component analysis of a Graph.
+ *
+ * Used by edge_cut when EdgeCut_Options::component_analysis is set: the
+ * large components are partitioned together by the multilevel algorithm,
+ * and the small components are packed whole onto the two parts.
+ */
+
+// #pragma once
+#ifndef MONGOOSE_COMPONENTS_HPP
+#define MONGOOSE_COMPONENTS_HPP
+
+#include "Mongoose_EdgeCut.hpp"
+#include "Mongoose_EdgeCutOptions.hpp"
+#include "Mongoose_Graph.hpp"
+#include "Mongoose_Internal.hpp"
+
+namespace Mongoose
+{
+
+Int findComponents(const Graph *graph, Int *component, Int *queue);
+EdgeCut *edgeCutByComponents(const Graph *graph,
+                             const EdgeCut_Options *options);
+
+} // end namespace Mongoose
+
+#endif
@@ -34,6 +34,18 @@ struct EdgeCut
                             is imbalanced, and this is
                             computed as (0.5 - W0/W).         */
 
+    /** Solver Statistics ****************************************************/
+    Int gradproj_iterations; /** Total # of gradient projection
+                                 iterations over all levels       */
+
+    /** Multilevel Statistics ************************************************/
+    EdgeCut_Level *levels; /** One entry per level, from the input graph
+                               (0) to the coarsest, or NULL unless
+                               collect_statistics is set          */
+    Int num_levels;        /** # entries in levels                */
+    Int peak_memory;       /** Peak bytes allocated by edge_cut, or
+                               -1 if memory accounting was off    */
+
     // desctructor (no constructor)
     ~EdgeCut();
 };
@@ -41,6 +53,7 @@ struct EdgeCut
 EdgeCut *edge_cut(const Graph *);
 EdgeCut *edge_cut(const Graph *, const EdgeCut_Options *);
 EdgeCut *edge_cut(EdgeCutProblem *problem, const EdgeCut_Options *options);
+EdgeCut *edgeCutWhole(const Graph *graph, const EdgeCut_Options *options);
 
 } // end namespace Mongoose
 
@@ -21,12 +21,21 @@ namespace Mongoose
 struct EdgeCut_Options
 {
     Int random_seed;
+    bool collect_statistics; /* Return per-level statistics with the cut */
+    double memory_limit;     /* Max bytes allocated by a cut (0: no limit) */
 
     /** Coarsening Options ***************************************************/
     Int coarsen_limit;
+    double coarsen_min_shrink; /* Stop coarsening when a level removes less
+                                  than this fraction of the vertices */
+    Int coarsen_max_levels;    /* Max # of coarsening levels (0: no limit)  */
     MatchingStrategy matching_strategy;
     bool do_community_matching;
     double high_degree_threshold;
+    bool component_analysis; /* Partition only the large connected
+                                components; pack the small ones */
+    VertexOrdering vertex_ordering; /* Renumber the graph for locality */
+    bool graph_reduction; /* Fold leaves and merge twins before coarsening */
 
     /** Guess Partitioning Options *******************************************/
     InitialEdgeCutType initial_cut_type; /* The guess cut type to use */
@@ -45,6 +54,10 @@ struct EdgeCut_Options
     bool use_QP_gradproj;         /* Flag governing the use of gradproj       */
     double gradproj_tolerance;   /* Convergence tol for projected gradient   */
     Int gradproj_iteration_limit; /* Max # of iterations for gradproj         */
+    bool gradproj_accelerate;     /* Use Barzilai-Borwein steps in gradproj   */
+    Int QP_band_depth;            /* If > 0, only vertices within this many
+                                     hops of the boundary are free in the QP */
+    NapsackSolver napsack_solver; /* Search used to find the napsack lambda   */
 
     /** Final Partition Target Metrics ***************************************/
     double target_split;        /* The desired split ratio (default 50/50)  */
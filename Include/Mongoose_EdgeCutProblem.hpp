@@ -24,10 +24,38 @@
 #include "Mongoose_Graph.hpp"
 #include "Mongoose_Internal.hpp"
 #include "Mongoose_EdgeCutOptions.hpp"
+#include "Mongoose_QPDelta.hpp"
 
 namespace Mongoose
 {
 
+/* Statistics of one level of the multilevel hierarchy, returned in
+   EdgeCut::levels when EdgeCut_Options::collect_statistics is set */
+struct EdgeCut_Level
+{
+    Int n;                   /** # vertices                            */
+    Int nz;                  /** # nonzeros in the adjacency matrix    */
+    double coarsening_ratio; /** n / n of the next finer level         */
+
+    /** Matching, by match type, of the vertices of this level ***********/
+    Int orphan_matches;
+    Int standard_matches;
+    Int brotherly_matches;
+    Int community_matches;
+
+    /** Refinement, in the last dance at this level **********************/
+    double cut_before_FM; /** Cut cost projected from the coarser level */
+    double cut_after_FM;  /** Cut cost after FM                         */
+    double cut_after_QP;  /** Cut cost after QP                         */
+    Int FM_moves;         /** # FM moves kept (all dances)              */
+    Int FM_moves_undone;  /** # FM moves rolled back (all dances)       */
+    Int QP_iterations;    /** # gradproj iterations (all dances)        */
+    double QP_residual;   /** Residual of the last gradproj run         */
+
+    /** Memory, while accounting is on (see MemoryAccounting) ************/
+    Int peak_memory; /** Peak bytes allocated at this level, or -1       */
+};
+
 class EdgeCutProblem
 {
 public:
@@ -44,7 +72,7 @@ public:
     double H; /** Heuristic max penalty to assess */
     double worstCaseRatio;
 
-    /** Partition Data *******************************************************/
+    /** Partition Data (see allocateRefinementArrays) *************************/
     bool *partition;     /** T/F denoting partition side     */
     double *vertexGains; /** Gains for each vertex           */
     Int *externalDegree; /** # edges lying across the cut    */
@@ -77,6 +105,14 @@ public:
                            3: Community                   */
     Int singleton;
 
+    /** QP Data **************************************************************/
+    QPDelta *qpWorkspace; /** QP workspace shared by all levels
+                              (not owned; NULL if unavailable)  */
+    Int gradprojIterations; /** # of gradproj iterations so far   */
+
+    /** Statistics ***********************************************************/
+    EdgeCut_Level stats; /** Statistics of this level          */
+
     /* Constructor & Destructor */
     static EdgeCutProblem *create(const Int _n, const Int _nz, Int *_p = NULL,
                                   Int *_i = NULL, double *_x = NULL, double *_w = NULL);
@@ -85,6 +121,19 @@ public:
     ~EdgeCutProblem();
     void initialize(const EdgeCut_Options *options);
 
+    /** Memory Functions ******************************************************/
+    static size_t memoryEstimate(Int _n, Int _nz, bool ownsGraph);
+    static size_t refinementEstimate(Int _n);
+    size_t memoryUsage() const;
+    void releaseRefinementArrays();
+    bool allocateRefinementArrays();
+    bool allocateMarkArray();
+
+    inline bool hasRefinementArrays() const
+    {
+        return (partition != NULL);
+    }
+
     /** Matching Functions ****************************************************/
     inline bool isMatched(Int vertex)
     {
@@ -108,18 +157,33 @@ public:
         cn++;
     }
 
+    /* Add the unmatched vertexB to the supervertex of vertexA. A 3-way
+       matching instead gives up a vertex to pair with vertexB; any other
+       cycle (vertexA alone, a pair, or a cluster of any size) takes vertexB
+       in after vertexA. */
     inline void createCommunityMatch(Int vertexA, Int vertexB,
                                      MatchType matchType)
     {
+        if (!isMatched(vertexA))
+        {
+            createMatch(vertexA, vertexB, matchType);
+            return;
+        }
+
         Int vm[4] = { -1, -1, -1, -1 };
         vm[0]     = vertexA;
         vm[1]     = getMatch(vm[0]);
         vm[2]     = getMatch(vm[1]);
         vm[3]     = getMatch(vm[2]);
 
-        bool is3Way = (vm[0] == vm[3]);
+        bool is3Way = (vm[0] == vm[3] && vm[0] != vm[1]);
         if (is3Way)
         {
+            /* Keep the supervertex on a vertex still in its cycle */
+            Int c = matchmap[vertexA];
+            if (invmatchmap[c] == vm[2])
+                invmatchmap[c] = vertexA;
+
             matching[vm[1]] = vertexA + 1;
             createMatch(vm[2], vertexB, matchType);
         }
@@ -0,0 +1,77 @@
+/* ========================================================================== */
+/* === Include/Mongoose_Generators.hpp ====================================== */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+/**
+ * Synthetic graph generators
+ *
+ * Build Graph objects directly from a size and a seed, without going through
+ * a file, so that benchmarks and tests can use graphs of any size. The same
+ * arguments always give the same graph, on any platform. Generated graphs are
+ * symmetric with no self-edges or duplicate edges, and have unit edge and
+ * vertex weights (x and w are NULL).
+ */
+
+// #pragma once
+#ifndef MONGOOSE_GENERATORS_HPP
+#define MONGOOSE_GENERATORS_HPP
+
+#include "Mongoose_Graph.hpp"
+#include "Mongoose_Internal.hpp"
+#include <string>
+
+namespace Mongoose
+{
+
+/**
+ * Generate an nx-by-ny-by-nz grid with a 5-point (nz = 1) or 7-point stencil.
+ */
+Graph *generate_grid(Int nx, Int ny, Int nz = 1);
+
+/**
+ * Generate the vertex graph of an nx-by-ny-by-nz mesh of bilinear (nz = 1) or
+ * trilinear finite elements: a 9-point or 27-point stencil.
+ */
+Graph *generate_mesh(Int nx, Int ny, Int nz = 1);
+
+/**
+ * Generate a random geometric graph: n points placed uniformly in the unit
+ * square, with an edge between every two points closer than the radius that
+ * gives the requested average degree.
+ */
+Graph *generate_geometric(Int n, double degree, Int seed);
+
+/**
+ * Generate an R-MAT (recursive matrix, or stochastic Kronecker) power-law
+ * graph with 2^scale vertices and edgeFactor * 2^scale edges drawn with the
+ * Graph500 probabilities (0.57, 0.19, 0.19, 0.05). Vertex numbers are
+ * randomly permuted, and self-edges and duplicate edges are dropped.
+ */
+Graph *generate_rmat(Int scale, Int edgeFactor, Int seed);
+
+/**
+ * Generate an Erdos-Renyi random graph with n vertices and n * degree / 2
+ * edges drawn uniformly at random; duplicate edges are dropped.
+ */
+Graph *generate_erdos_renyi(Int n, double degree, Int seed);
+
+/**
+ * Generate a graph from a specification "kind:size[:seed]", where kind is
+ * one of grid2d, grid3d, mesh2d, mesh3d (size vertices per side), geometric,
+ * er (size vertices, average degree 8), or rmat (2^size vertices, edge
+ * factor 16). The seed defaults to 1. Returns NULL if the specification
+ * is not valid.
+ */
+Graph *generate_graph(const std::string &spec);
+Graph *generate_graph(const char *spec);
+
+} // end namespace Mongoose
+
+#endif
@@ -51,6 +51,12 @@ private:
     bool shallow_i;
     bool shallow_x;
     bool shallow_w;
+
+    /** Binary file the arrays point into, released with the graph **********/
+    void *mapping;
+    size_t mappingSize;
+
+    friend Graph *read_graph_binary(const char *filename);
 };
 
 } // end namespace Mongoose
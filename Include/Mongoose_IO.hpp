@@ -25,6 +25,7 @@
 #include "Mongoose_CSparse.hpp"
 #include "Mongoose_Graph.hpp"
 #include "Mongoose_Internal.hpp"
+#include <stdint.h>
 #include <string>
 
 extern "C"
@@ -40,9 +41,12 @@ namespace Mongoose
  *
  * Generate a Graph class instance from a Matrix Market file. The matrix
  * contained in the file must be sparse, real, and square. If the matrix
- * is not symmetric, it will be made symmetric with (A+A')/2. If the matrix has
- * more than one connected component, the largest will be found and the rest
- * discarded. If a diagonal is present, it will be removed.
+ * is not symmetric, it will be made symmetric with (A+A')/2. All connected
+ * components are kept (see EdgeCut_Options::component_analysis for handling
+ * disconnected graphs). If a diagonal is present, it will be removed. A
+ * binary graph file (see write_graph_binary) is also accepted, and is loaded
+ * with read_graph_binary, as is a METIS graph file ending in ".graph", which is
+ * loaded with read_graph_metis.
  *
  * @param filename the filename or path to the Matrix Market File.
  */
@@ -53,9 +57,9 @@ Graph *read_graph(const std::string &filename);
  *
  * Generate a cs struct instance from a Matrix Market file. The matrix
  * contained in the file must be sparse, real, and square. If the matrix
- * is not symmetric, it will be made symmetric with (A+A')/2. If the matrix has
- * more than one connected component, the largest will be found and the rest
- * discarded. If a diagonal is present, it will be removed.
+ * is not symmetric, it will be made symmetric with (A+A')/2. All connected
+ * components are kept (see EdgeCut_Options::component_analysis for handling
+ * disconnected graphs). If a diagonal is present, it will be removed.
  *
  * @param filename the filename or path to the Matrix Market File.
  * @param matcode the four character Matrix Market type code.
@@ -67,28 +71,229 @@ cs *read_matrix(const std::string &filename, MM_typecode &matcode);
  *
  * Generate a Graph class instance from a Matrix Market file. The matrix
  * contained in the file must be sparse, real, and square. If the matrix
- * is not symmetric, it will be made symmetric with (A+A')/2. If the matrix has
- * more than one connected component, the largest will be found and the rest
- * discarded. If a diagonal is present, it will be removed.
+ * is not symmetric, it will be made symmetric with (A+A')/2. All connected
+ * components are kept (see EdgeCut_Options::component_analysis for handling
+ * disconnected graphs). If a diagonal is present, it will be removed. A
+ * binary graph file (see write_graph_binary) is also accepted, and is loaded
+ * with read_graph_binary, as is a METIS graph file ending in ".graph", which is
+ * loaded with read_graph_metis.
  *
  * @param filename the filename or path to the Matrix Market File.
  */
 Graph *read_graph(const char *filename);
 
+/**
+ * Generate a Graph from a Matrix Market file, using a cache.
+ *
+ * If use_cache is true, the sanitized graph is saved as a binary graph file
+ * named filename.mgb next to the Matrix Market file, together with a hash of
+ * the Matrix Market file. Later calls with use_cache set load the cache with
+ * read_graph_binary instead of parsing and sanitizing the file again. The
+ * cache is rebuilt if the hash no longer matches. A cache that cannot be
+ * written is not an error. If use_cache is false, this is the same as
+ * read_graph(filename).
+ *
+ * @param filename the filename or path to the Matrix Market File.
+ * @param use_cache whether to read and write the cache.
+ */
+Graph *read_graph(const std::string &filename, bool use_cache);
+
+/**
+ * Generate a Graph from a Matrix Market file, using a cache.
+ *
+ * If use_cache is true, the sanitized graph is saved as a binary graph file
+ * named filename.mgb next to the Matrix Market file, together with a hash of
+ * the Matrix Market file. Later calls with use_cache set load the cache with
+ * read_graph_binary instead of parsing and sanitizing the file again. The
+ * cache is rebuilt if the hash no longer matches. A cache that cannot be
+ * written is not an error. If use_cache is false, this is the same as
+ * read_graph(filename).
+ *
+ * @param filename the filename or path to the Matrix Market File.
+ * @param use_cache whether to read and write the cache.
+ */
+Graph *read_graph(const char *filename, bool use_cache);
+
 /**
  * Generate a CSparse matrix from a Matrix Market file.
  *
  * Generate a cs struct instance from a Matrix Market file. The matrix
  * contained in the file must be sparse, real, and square. If the matrix
- * is not symmetric, it will be made symmetric with (A+A')/2. If the matrix has
- * more than one connected component, the largest will be found and the rest
- * discarded. If a diagonal is present, it will be removed.
+ * is not symmetric, it will be made symmetric with (A+A')/2. All connected
+ * components are kept (see EdgeCut_Options::component_analysis for handling
+ * disconnected graphs). If a diagonal is present, it will be removed.
  *
  * @param filename the filename or path to the Matrix Market File.
  * @param matcode the four character Matrix Market type code.
  */
 cs *read_matrix(const char *filename, MM_typecode &matcode);
 
+/**
+ * Generate a Graph from a Matrix Market file using bounded memory.
+ *
+ * Gives the same graph as read_graph, but builds it in two passes over the
+ * file instead of holding the triplets, the compressed matrix and the
+ * sanitized copies at once. The first pass counts the entries of each
+ * vertex of (A+A')/2, and the second places them directly in the Graph,
+ * dropping the diagonal. Duplicate edges are then summed in place. Peak
+ * memory is the size of the Graph plus work space the size of the largest
+ * adjacency list. A symmetric pattern matrix gives a Graph without edge
+ * weights.
+ *
+ * @param filename the filename or path to the Matrix Market File.
+ */
+Graph *read_graph_streaming(const std::string &filename);
+
+/**
+ * Generate a Graph from a Matrix Market file using bounded memory.
+ *
+ * Gives the same graph as read_graph, but builds it in two passes over the
+ * file instead of holding the triplets, the compressed matrix and the
+ * sanitized copies at once. The first pass counts the entries of each
+ * vertex of (A+A')/2, and the second places them directly in the Graph,
+ * dropping the diagonal. Duplicate edges are then summed in place. Peak
+ * memory is the size of the Graph plus work space the size of the largest
+ * adjacency list. A symmetric pattern matrix gives a Graph without edge
+ * weights.
+ *
+ * @param filename the filename or path to the Matrix Market File.
+ */
+Graph *read_graph_streaming(const char *filename);
+
+/**
+ * Generate a Graph from a METIS or Chaco graph file.
+ *
+ * The file holds the adjacency list of each vertex on its own line, after
+ * a header line "n m [fmt [ncon]]" giving the number of vertices and edges.
+ * fmt selects vertex sizes (ignored), vertex weights and edge weights, as in
+ * METIS; only one vertex weight per vertex (ncon = 1) is supported. Lines
+ * starting with '%' are comments. The Graph is built directly from the
+ * adjacency lists. Only if the file does not hold 2m entries or has
+ * self-edges is it sanitized as a Matrix Market file would be.
+ *
+ * @param filename the filename or path of the METIS graph file.
+ */
+Graph *read_graph_metis(const std::string &filename);
+
+/**
+ * Generate a Graph from a METIS or Chaco graph file.
+ *
+ * The file holds the adjacency list of each vertex on its own line, after
+ * a header line "n m [fmt [ncon]]" giving the number of vertices and edges.
+ * fmt selects vertex sizes (ignored), vertex weights and edge weights, as in
+ * METIS; only one vertex weight per vertex (ncon = 1) is supported. Lines
+ * starting with '%' are comments. The Graph is built directly from the
+ * adjacency lists. Only if the file does not hold 2m entries or has
+ * self-edges is it sanitized as a Matrix Market file would be.
+ *
+ * @param filename the filename or path of the METIS graph file.
+ */
+Graph *read_graph_metis(const char *filename);
+
+/**
+ * Header of a binary graph file.
+ *
+ * A binary graph file holds a Graph exactly as Mongoose uses it, so that it
+ * can be loaded without parsing, compressing or sanitizing. The header is
+ * followed by the arrays p (n+1 Ints), i (nz Ints), and optionally x (nz
+ * doubles) and w (n doubles). Each array starts on a BINARY_GRAPH_ALIGN byte
+ * boundary, and its offset from the start of the file is stored in the
+ * header (0 for an absent x or w). All values are little-endian.
+ *
+ * A graph cached by read_graph also records the hash of the Matrix Market
+ * file it was read from, so that a stale cache can be detected.
+ */
+#define BINARY_GRAPH_MAGIC "MONGOOSE"
+#define BINARY_GRAPH_VERSION 2
+#define BINARY_GRAPH_ALIGN 64
+#define BINARY_GRAPH_BYTE_ORDER 0x01020304
+
+struct BinaryGraphHeader
+{
+    char magic[8];       /** BINARY_GRAPH_MAGIC (not null-terminated) */
+    uint32_t version;    /** BINARY_GRAPH_VERSION                     */
+    uint32_t byteOrder;  /** BINARY_GRAPH_BYTE_ORDER                  */
+    uint32_t intSize;    /** sizeof(Int)                              */
+    uint32_t doubleSize; /** sizeof(double)                           */
+    int64_t n;           /** # vertices                               */
+    int64_t nz;          /** # edges                                  */
+    uint64_t offsetP;    /** Offset of the column pointers            */
+    uint64_t offsetI;    /** Offset of the row indices                */
+    uint64_t offsetX;    /** Offset of the edge weights, or 0         */
+    uint64_t offsetW;    /** Offset of the node weights, or 0         */
+    uint64_t fileSize;   /** Total size of the file in bytes          */
+    uint64_t sourceHash; /** Hash of the source file, or 0            */
+};
+
+/**
+ * Write a Graph to a binary graph file.
+ *
+ * The graph is written as is, so it should already be sanitized (as it is
+ * when returned by read_graph).
+ *
+ * @param graph the graph to write.
+ * @param filename the filename or path of the binary graph file.
+ * @return true on success, false if the file could not be written.
+ */
+bool write_graph_binary(const Graph *graph, const std::string &filename);
+
+/**
+ * Write a Graph to a binary graph file.
+ *
+ * The graph is written as is, so it should already be sanitized (as it is
+ * when returned by read_graph).
+ *
+ * @param graph the graph to write.
+ * @param filename the filename or path of the binary graph file.
+ * @return true on success, false if the file could not be written.
+ */
+bool write_graph_binary(const Graph *graph, const char *filename);
+
+/**
+ * Generate a Graph from a binary graph file.
+ *
+ * Where supported, the file is memory-mapped and the Graph points directly
+ * into the mapping, which is released when the Graph is destroyed. Pages are
+ * mapped copy-on-write, so changes to the Graph are never written back.
+ * Otherwise, the file is read into memory in one piece. The column pointers
+ * must be nondecreasing from p[0] = 0 to p[n] = nz and the row indices lie
+ * in [0, n), or the file is rejected; the weights are not checked.
+ *
+ * @param filename the filename or path of the binary graph file.
+ */
+Graph *read_graph_binary(const std::string &filename);
+
+/**
+ * Generate a Graph from a binary graph file.
+ *
+ * Where supported, the file is memory-mapped and the Graph points directly
+ * into the mapping, which is released when the Graph is destroyed. Pages are
+ * mapped copy-on-write, so changes to the Graph are never written back.
+ * Otherwise, the file is read into memory in one piece. The column pointers
+ * must be nondecreasing from p[0] = 0 to p[n] = nz and the row indices lie
+ * in [0, n), or the file is rejected; the weights are not checked.
+ *
+ * @param filename the filename or path of the binary graph file.
+ */
+Graph *read_graph_binary(const char *filename);
+
+/* Helpers for binary graph files */
+bool isBinaryGraphFile(const char *filename);
+bool writeBinaryGraph(const Graph *graph, const char *filename,
+                      uint64_t sourceHash);
+bool writeBinaryGraph(const Graph *graph, FILE *file, const char *filename,
+                      uint64_t sourceHash);
+FILE *createTempFile(const std::string &prefix, std::string *name);
+bool readBinaryGraphSourceHash(const char *filename, uint64_t *sourceHash);
+bool hashFile(const char *filename, uint64_t *hash);
+bool hasExtension(const char *filename, const char *extension);
+bool streamMatrixEntries(FILE *file, Int n, Int nnz, bool pattern,
+                         bool symmetric, Int *p, Int *Ai, double *Ax);
+Int combineDuplicates(Int n, Int *p, Int *Ai, double *Ax);
+bool binaryGraphArraysAreValid(const Int *p, const Int *i, Int n, Int nz);
+bool binaryGraphHeaderIsValid(const BinaryGraphHeader *header,
+                              uint64_t fileSize);
+
 } // end namespace Mongoose
 
 #endif
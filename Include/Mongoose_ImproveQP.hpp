@@ -24,6 +24,13 @@ namespace Mongoose
 
 bool improveCutUsingQP(EdgeCutProblem *, const EdgeCut_Options *, bool isInitial = false);
 
+/* Build the subgraph induced by the vertices within options->QP_band_depth
+ * hops of the boundary. On success, bandList holds the band vertices (band
+ * vertex k is bandList[k] in the graph) and they are left marked in the graph.
+ * Returns NULL if the band is empty, covers the graph, or memory runs out. */
+EdgeCutProblem *createBandProblem(EdgeCutProblem *, const EdgeCut_Options *,
+                                  Int *bandList);
+
 } // end namespace Mongoose
 
 #endif
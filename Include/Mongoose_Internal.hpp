@@ -30,6 +30,11 @@
 /* Memory Management */
 #include "SuiteSparse_config.h"
 
+/* Memory-mapped files are used for binary graphs where available */
+#if defined(__unix__) || defined(__APPLE__)
+#define MONGOOSE_HAVE_MMAP
+#endif
+
 namespace Mongoose
 {
 
@@ -39,13 +44,25 @@ typedef SuiteSparse_long Int;
 #define MAX_INT SuiteSparse_long_max
 #endif
 
+/* Memory management. Mongoose allocates through these, which take the same
+   arguments as the SuiteSparse_config functions they call, and keep the size
+   of each block in a header for memory accounting (see MemoryAccounting).
+   A block they allocate must be freed with mongoose_free, never with
+   SuiteSparse_free, and vice versa. */
+void *mongoose_malloc(size_t nitems, size_t size_of_item);
+void *mongoose_calloc(size_t nitems, size_t size_of_item);
+void *mongoose_realloc(size_t nitems_new, size_t nitems_old,
+                       size_t size_of_item, void *p, int *ok);
+void *mongoose_free(void *p);
+
 /* Enumerations */
 enum MatchingStrategy
 {
     Random   = 0,
     HEM      = 1,
     HEMSR    = 2,
-    HEMSRdeg = 3
+    HEMSRdeg = 3,
+    LabelProp = 4
 };
 
 enum InitialEdgeCutType
@@ -55,6 +72,19 @@ enum InitialEdgeCutType
     InitialEdgeCut_NaturalOrder = 2
 };
 
+enum NapsackSolver
+{
+    NapsackSolver_Heap      = 0,
+    NapsackSolver_Selection = 1
+};
+
+enum VertexOrdering
+{
+    VertexOrdering_Natural = 0,
+    VertexOrdering_BFS     = 1,
+    VertexOrdering_RCM     = 2
+};
+
 enum MatchType
 {
     MatchType_Orphan    = 0,
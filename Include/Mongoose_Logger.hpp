@@ -16,15 +16,23 @@
  * allows this information to be displayed (or not) without recompilation.
  * Timing inforation for different *portions of the library are also managed
  * here with a tic/toc pattern.
+ *
+ * Times are measured on a monotonic wall clock and kept separately for each
+ * thread, both in total and per coarsening level, so that several partitions
+ * computed concurrently do not disturb each other's timings.
  */
 
 // #pragma once
 #ifndef MONGOOSE_LOGGER_HPP
 #define MONGOOSE_LOGGER_HPP
 
+#include "Mongoose_Internal.hpp"
+#include "Mongoose_MemoryAccounting.hpp"
+#include "Mongoose_PerfCounters.hpp"
+#include "Mongoose_Trace.hpp"
+#include <chrono>
 #include <iostream>
 #include <string>
-#include <time.h>
 
 // Default Logging Levels
 #ifndef LOG_ERROR
@@ -89,91 +97,158 @@ typedef enum TimingType
     RefinementTiming = 2,
     FMTiming         = 3,
     QPTiming         = 4,
-    IOTiming         = 5
+    IOTiming         = 5,
+    SanitizeTiming   = 6,
+    GuessCutTiming   = 7
 } TimingType;
 
 class Logger
 {
+public:
+    static const int NumTimingTypes  = 8;
+    static const int MaxTimingLevels = 64;
+
 private:
     static int debugLevel;
     static bool timingOn;
-    static clock_t clocks[6];
-    static float times[6];
+    static thread_local double starts[NumTimingTypes];
+    static thread_local double times[NumTimingTypes];
+    static thread_local double levelTimes[MaxTimingLevels][NumTimingTypes];
+    static thread_local int level;
+    static thread_local int numLevels;
+    static const char *const timingNames[NumTimingTypes];
+
+    static inline double now();
 
 public:
-    static inline void tic(TimingType timingType);
+    static inline void tic(TimingType timingType, Int size = -1);
     static inline void toc(TimingType timingType);
-    static inline float getTime(TimingType timingType);
+    static inline double getTime(TimingType timingType);
+    static double getTime(TimingType timingType, Int level);
+    static Int getTimingLevels();
+    static void setTimingLevel(Int level);
+    static inline Int getTimingLevel();
+    static void resetTiming();
     static inline int getDebugLevel();
     static void setDebugLevel(int debugType);
     static void setTimingFlag(bool tFlag);
     static void printTimingInfo();
 };
 
+/* Seconds on a monotonic wall clock, from an arbitrary origin */
+inline double Logger::now()
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
 /**
  * Start a timer for a given type/part of the code.
  *
  * Given a timingType (MatchingTiming, CoarseningTiming, RefinementTiming,
- * FMTiming, QPTiming, or IOTiming), a clock is started for that computation.
- * The general structure is to call tic(IOTiming) at the beginning of an I/O
- * operation, then call toc(IOTiming) at the end of the I/O operation.
+ * FMTiming, QPTiming, IOTiming, SanitizeTiming, or GuessCutTiming), a clock
+ * is started for that computation. The general structure is to call
+ * tic(IOTiming) at the beginning of an I/O operation, then call toc(IOTiming)
+ * at the end of the I/O operation.
  *
  * Note that problems can occur and timing results may be inaccurate if a tic
- * is followed by another tic (or a toc is followed by another toc).
+ * is followed by another tic (or a toc is followed by another toc) of the
+ * same type on the same thread. Timers of different types may be nested: the
+ * guess cut time includes the QP and FM time spent computing it, and the I/O
+ * time includes the time spent sanitizing the matrix read.
+ *
+ * If tracing is on (see Trace), the beginning of the phase is also recorded,
+ * if hardware counters are on (see PerfCounters), they are read, and if
+ * memory accounting is on (see MemoryAccounting), the peak memory of the
+ * phase starts to be tracked.
  *
- * @param timingType The portion of the library being timed (MatchingTiming,
- *   CoarseningTiming, RefinementTiming, FMTiming, QPTiming, or IOTiming).
+ * @param timingType The portion of the library being timed.
+ * @param size The size of the problem being worked on, or -1 if not known.
+ *   Only used for tracing.
  */
-inline void Logger::tic(TimingType timingType)
+inline void Logger::tic(TimingType timingType, Int size)
 {
+    if (Trace::isOn())
+        Trace::begin(timingNames[timingType], size);
     if (timingOn)
     {
-        clocks[timingType] = clock();
+        starts[timingType] = now();
     }
+    if (PerfCounters::isOn())
+        PerfCounters::begin(timingType);
+    if (MemoryAccounting::isOn())
+        MemoryAccounting::begin(timingType);
 }
 
 /**
  * Stop a timer for a given type/part of the code.
  *
- * Given a timingType (MatchingTiming, CoarseningTiming, RefinementTiming,
- * FMTiming, QPTiming, or IOTiming), a clock is stopped for that computation.
- * The general structure is to call tic(IOTiming) at the beginning of an I/O
- * operation, then call toc(IOTiming) at the end of the I/O operation.
- *
- * Note that problems can occur and timing results may be inaccurate if a tic
- * is followed by another tic (or a toc is followed by another toc).
+ * The time elapsed since the matching tic on this thread is added to the
+ * total for timingType and to its total for the current coarsening level
+ * (see setTimingLevel), and so are the hardware counts if counters are on.
  *
- * @param timingType The portion of the library being timed (MatchingTiming,
- *   CoarseningTiming, RefinementTiming, FMTiming, QPTiming, or IOTiming).
+ * @param timingType The portion of the library being timed.
  */
 inline void Logger::toc(TimingType timingType)
 {
+    if (MemoryAccounting::isOn())
+        MemoryAccounting::end(timingType);
+    if (PerfCounters::isOn())
+        PerfCounters::end(timingType);
+    if (Trace::isOn())
+        Trace::end(timingNames[timingType]);
     if (timingOn)
     {
-        times[timingType]
-            += ((float)(clock() - clocks[timingType])) / CLOCKS_PER_SEC;
+        double elapsed = now() - starts[timingType];
+        times[timingType] += elapsed;
+        levelTimes[level][timingType] += elapsed;
     }
 }
 
 /**
  * Get the time recorded for a given timing type.
  *
- * Retreive the total clock time for a given timing type (MatchingTiming,
- * CoarseningTiming, RefinementTiming, FMTiming, QPTiming, or IOTiming).
+ * Retreive the total wall clock time, in seconds, recorded on this thread
+ * for a given timing type since the last call to resetTiming.
  *
- * @param timingType The portion of the library being timed (MatchingTiming,
- *   CoarseningTiming, RefinementTiming, FMTiming, QPTiming, or IOTiming).
+ * @param timingType The portion of the library being timed.
  */
-inline float Logger::getTime(TimingType timingType)
+inline double Logger::getTime(TimingType timingType)
 {
     return times[timingType];
 }
 
+/* The coarsening level timings are charged to on this thread */
+inline Int Logger::getTimingLevel()
+{
+    return level;
+}
+
 inline int Logger::getDebugLevel()
 {
     return debugLevel;
 }
 
+/* Free-function interface to the timings of the calling thread, also
+   declared in Mongoose.hpp */
+void set_timing(bool enabled);
+void reset_timing();
+double get_timing(TimingType timingType);
+double get_timing(TimingType timingType, Int level);
+Int get_timing_levels();
+bool set_perf_counters(bool enabled);
+double get_perf_counter(TimingType timingType, PerfCounterType counter);
+double get_perf_counter(TimingType timingType, PerfCounterType counter,
+                        Int level);
+void set_memory_accounting(bool enabled);
+Int get_memory_in_use();
+Int get_memory_peak();
+Int get_memory_peak(TimingType timingType);
+Int get_memory_peak(TimingType timingType, Int level);
+Int get_memory_allocated(TimingType timingType);
+Int get_memory_allocated(TimingType timingType, Int level);
+
 } // end namespace Mongoose
 
 #endif
@@ -26,6 +26,8 @@ void matching_Random(EdgeCutProblem *, const EdgeCut_Options *);
 void matching_HEM(EdgeCutProblem *, const EdgeCut_Options *);
 void matching_SR(EdgeCutProblem *, const EdgeCut_Options *);
 void matching_SRdeg(EdgeCutProblem *, const EdgeCut_Options *);
+void matching_LabelProp(EdgeCutProblem *, const EdgeCut_Options *);
+void matching_TwoHop(EdgeCutProblem *, const EdgeCut_Options *);
 void matching_Cleanup(EdgeCutProblem *, const EdgeCut_Options *);
 
 } // end namespace Mongoose
@@ -0,0 +1,70 @@
+/* ========================================================================== */
+/* === Include/Mongoose_MemoryAccounting.hpp ================================ */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+/**
+ * Memory accounting
+ *
+ * Mongoose allocates through mongoose_malloc and its siblings (see
+ * Mongoose_Internal.hpp), which keep the size of each block in a header.
+ * While accounting is on, the blocks allocated by the calling thread are
+ * counted: the bytes in use and their peak are kept per thread, and the peak
+ * is also kept per timing type and per coarsening level, next to the
+ * timings: the peak of a timing type is the most bytes in use at any time
+ * while it ran. The SuiteSparse_config allocation functions are left alone,
+ * and all the state is thread-local, so accounting can be turned on and off
+ * while other threads allocate.
+ *
+ * Only blocks allocated while accounting is on are counted; freeing a block
+ * allocated before that, or by another thread, has no effect.
+ *
+ * Timing types are passed as int, since this header is included by the
+ * Logger that defines them.
+ */
+
+// #pragma once
+#ifndef MONGOOSE_MEMORYACCOUNTING_HPP
+#define MONGOOSE_MEMORYACCOUNTING_HPP
+
+#include "Mongoose_Internal.hpp"
+
+namespace Mongoose
+{
+
+class MemoryAccounting
+{
+private:
+    static thread_local bool accountingOn;
+
+public:
+    static inline bool isOn();
+    static void setAccountingFlag(bool aFlag);
+    static void begin(int timingType);
+    static void end(int timingType);
+    static Int inUse();
+    static Int peak();
+    static Int peak(int timingType);
+    static Int peak(int timingType, Int level);
+    static Int allocated(int timingType);
+    static Int allocated(int timingType, Int level);
+    static Int startPeak();
+    static Int stopPeak(Int outerPeak);
+    static void reset();
+};
+
+/* Whether the allocations of the calling thread are being counted */
+inline bool MemoryAccounting::isOn()
+{
+    return accountingOn;
+}
+
+} // end namespace Mongoose
+
+#endif
@@ -0,0 +1,42 @@
+/* ========================================================================== */
+/* === Include/Mongoose_Ordering.hpp ======================================== */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+/**
+ * Locality-improving vertex orderings.
+ *
+ * Used by edge_cut when EdgeCut_Options::vertex_ordering is not
+ * VertexOrdering_Natural: the graph is renumbered by breadth-first search or
+ * reverse Cuthill-McKee, partitioned in that order, and the partition is
+ * mapped back to the caller's numbering. Coarse graphs are then numbered in
+ * the order of their fine vertices so that they keep the same locality.
+ */
+
+// #pragma once
+#ifndef MONGOOSE_ORDERING_HPP
+#define MONGOOSE_ORDERING_HPP
+
+#include "Mongoose_EdgeCut.hpp"
+#include "Mongoose_EdgeCutOptions.hpp"
+#include "Mongoose_EdgeCutProblem.hpp"
+#include "Mongoose_Graph.hpp"
+#include "Mongoose_Internal.hpp"
+
+namespace Mongoose
+{
+
+Int *vertexOrdering(const Graph *graph, VertexOrdering ordering);
+Graph *permuteGraph(const Graph *graph, const Int *perm);
+EdgeCut *edgeCutOrdered(const Graph *graph, const EdgeCut_Options *options);
+void orderCoarseVertices(EdgeCutProblem *graph);
+
+} // end namespace Mongoose
+
+#endif
@@ -0,0 +1,68 @@
+/* ========================================================================== */
+/* === Include/Mongoose_PerfCounters.hpp ==================================== */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+/**
+ * Hardware performance counters
+ *
+ * When counting is on (Linux only), the hardware counters of the calling
+ * thread are read with perf_event_open at each Logger::tic and Logger::toc,
+ * and the counts are accumulated per timing type and per coarsening level,
+ * next to the timings. Counters the processor, kernel or virtual machine
+ * does not provide are reported as unavailable.
+ *
+ * Timing types are passed as int, since this header is included by the
+ * Logger that defines them.
+ */
+
+// #pragma once
+#ifndef MONGOOSE_PERFCOUNTERS_HPP
+#define MONGOOSE_PERFCOUNTERS_HPP
+
+#include "Mongoose_Internal.hpp"
+
+namespace Mongoose
+{
+
+typedef enum PerfCounterType
+{
+    CyclesCounter       = 0,
+    InstructionsCounter = 1,
+    LLCMissesCounter    = 2,
+    BranchMissesCounter = 3,
+    DTLBMissesCounter   = 4
+} PerfCounterType;
+
+class PerfCounters
+{
+private:
+    static bool countersOn;
+
+public:
+    static const int NumCounters = 5;
+
+    static inline bool isOn();
+    static bool setCountersFlag(bool cFlag);
+    static void begin(int timingType);
+    static void end(int timingType);
+    static double get(int timingType, PerfCounterType counter);
+    static double get(int timingType, PerfCounterType counter, Int level);
+    static bool isAvailable(PerfCounterType counter);
+    static void reset();
+};
+
+inline bool PerfCounters::isOn()
+{
+    return countersOn;
+}
+
+} // end namespace Mongoose
+
+#endif
@@ -52,11 +52,17 @@ public:
 
     double lambda;
 
+    Int numVars; /* capacity of the workspace; problems of this size or
+                    smaller can reuse it                               */
+
     static QPDelta *Create(Int numVars);
+    static size_t memoryEstimate(Int numVars);
     ~QPDelta();
 
 #ifndef NDEBUG
     double check_cost;
+    double *gradientOffset; /* constant part of the gradient, from vertices
+                               outside a band QP (NULL if none)    */
 #endif
 };
 
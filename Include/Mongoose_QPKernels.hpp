@@ -0,0 +1,65 @@
+/* ========================================================================== */
+/* === Include/Mongoose_QPKernels.hpp ======================================= */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+/**
+ * Dense vector kernels used by the QP refinement.
+ *
+ * Each kernel has a scalar version, and on x86 with GCC or Clang, AVX2 and
+ * AVX-512 versions. The fastest version supported by the CPU is selected the
+ * first time a kernel is called.
+ */
+
+// #pragma once
+#ifndef MONGOOSE_QPKERNELS_HPP
+#define MONGOOSE_QPKERNELS_HPP
+
+#include "Mongoose_Internal.hpp"
+
+namespace Mongoose
+{
+
+enum QPKernelISA
+{
+    QPKernelISA_Scalar = 0,
+    QPKernelISA_AVX2   = 1,
+    QPKernelISA_AVX512 = 2
+};
+
+/* grad = (0.5 - x) .* D */
+void QPKernel_gradientInit(double *grad, const double *x, const double *D,
+                           Int n);
+
+/* y = x - st * grad */
+void QPKernel_step(double *y, const double *x, double st, const double *grad,
+                   Int n);
+
+/* y = y + st * x */
+void QPKernel_axpy(double *y, double st, const double *x, Int n);
+
+/* x = 0 */
+void QPKernel_zero(double *x, Int n);
+
+/* max (abs (y - x)), or -INFINITY if n is zero */
+double QPKernel_maxAbsDiff(const double *y, const double *x, Int n);
+
+/* a'proj (x - lambda*a), where proj is the projection onto [0,1] and a
+ * is taken to be all ones if NULL */
+double QPKernel_napsackSlope(const double *x, const double *a, double lambda,
+                             Int n);
+
+/* The instruction set used by the kernels. QPKernel_setISA returns false
+ * (and changes nothing) if the CPU or compiler does not support isa. */
+QPKernelISA QPKernel_getISA();
+bool QPKernel_setISA(QPKernelISA isa);
+
+} // end namespace Mongoose
+
+#endif
@@ -0,0 +1,34 @@
+/* ========================================================================== */
+/* === Include/Mongoose_QPNapSelect.hpp ===================================== */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+// #pragma once
+#ifndef MONGOOSE_QPNAPSELECT_HPP
+#define MONGOOSE_QPNAPSELECT_HPP
+
+#include "Mongoose_Internal.hpp"
+
+namespace Mongoose
+{
+
+double QPNapSelect      /* return lambda */
+    (const double *x,   /* holds y on input, not modified */
+     Int n,             /* size of x */
+     double lambda_lo,  /* lower bound on lambda (may be -INFINITY) */
+     double lambda_hi,  /* upper bound on lambda (may be +INFINITY) */
+     const double *a,   /* input constraint vector */
+     double b,          /* input constraint scalar */
+     double *breakpts,  /* work array of size n */
+     Int *undecided     /* work array of size n */
+    );
+
+} // end namespace Mongoose
+
+#endif
@@ -31,7 +31,8 @@ double QPNapsack    /* return the final lambda */
      double *w,  /* work array of size n */
      Int *heap1, /* work array of size n+1 */
      Int *heap2, /* work array of size n+1 */
-     double tol);
+     double tol,
+     NapsackSolver solver = NapsackSolver_Heap);
 
 } // end namespace Mongoose
 
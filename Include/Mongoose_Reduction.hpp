@@ -0,0 +1,41 @@
+/* ========================================================================== */
+/* === Include/Mongoose_Reduction.hpp ======================================= */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+/**
+ * Exact pre-reduction of a Graph.
+ *
+ * Used by edge_cut when EdgeCut_Options::graph_reduction is set: chains of
+ * degree-1 vertices are folded into their neighbors and vertices with the
+ * same neighborhood (twins) are merged into weighted super-vertices. Any
+ * partition of the reduced graph expands to a partition of the original
+ * graph with the same cut and balance.
+ */
+
+// #pragma once
+#ifndef MONGOOSE_REDUCTION_HPP
+#define MONGOOSE_REDUCTION_HPP
+
+#include "Mongoose_EdgeCut.hpp"
+#include "Mongoose_EdgeCutOptions.hpp"
+#include "Mongoose_Graph.hpp"
+#include "Mongoose_Internal.hpp"
+
+namespace Mongoose
+{
+
+Int foldLeaves(const Graph *graph, double maxWeight, Int *map);
+Int mergeTwins(const Graph *graph, double maxWeight, Int *map);
+Graph *contractGraph(const Graph *graph, const Int *map, Int cn);
+EdgeCut *edgeCutReduced(const Graph *graph, const EdgeCut_Options *options);
+
+} // end namespace Mongoose
+
+#endif
@@ -0,0 +1,61 @@
+/* ========================================================================== */
+/* === Include/Mongoose_Trace.hpp =========================================== */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+/**
+ * Timeline tracing
+ *
+ * When tracing is on, the beginning and end of each phase timed by the Logger
+ * (and of QPGradProj and QPNapsack) are recorded as events carrying the
+ * coarsening level, the thread, and the size of the problem. The events are
+ * written in the Chrome trace event format, which chrome://tracing and
+ * Perfetto display as a timeline. When tracing is off, recording an event
+ * costs a single test.
+ */
+
+// #pragma once
+#ifndef MONGOOSE_TRACE_HPP
+#define MONGOOSE_TRACE_HPP
+
+#include "Mongoose_Internal.hpp"
+#include <atomic>
+#include <string>
+
+namespace Mongoose
+{
+
+class Trace
+{
+private:
+    static std::atomic<bool> tracingOn;
+
+public:
+    static inline bool isOn();
+    static void begin(const char *name, Int size);
+    static void end(const char *name);
+    static void setTracingFlag(bool tFlag);
+    static bool write(const char *filename);
+    static void clear();
+};
+
+inline bool Trace::isOn()
+{
+    return tracingOn;
+}
+
+/* Free-function interface to tracing, also declared in Mongoose.hpp */
+void set_tracing(bool enabled);
+bool write_trace(const std::string &filename);
+bool write_trace(const char *filename);
+void clear_trace();
+
+} // end namespace Mongoose
+
+#endif
@@ -21,10 +21,17 @@ EdgeCut_Options *mex_get_options
         return returner;
 
     MEX_STRUCT_READINT(random_seed);
+    MEX_STRUCT_READBOOL(collect_statistics);
+    MEX_STRUCT_READDOUBLE(memory_limit);
     MEX_STRUCT_READINT(coarsen_limit);
+    MEX_STRUCT_READDOUBLE(coarsen_min_shrink);
+    MEX_STRUCT_READINT(coarsen_max_levels);
     MEX_STRUCT_READENUM(matching_strategy, MatchingStrategy);
     MEX_STRUCT_READBOOL(do_community_matching);
     MEX_STRUCT_READDOUBLE(high_degree_threshold);
+    MEX_STRUCT_READBOOL(component_analysis);
+    MEX_STRUCT_READENUM(vertex_ordering, VertexOrdering);
+    MEX_STRUCT_READBOOL(graph_reduction);
     
     /** Guess Partitioning Options *******************************************/
     MEX_STRUCT_READENUM(initial_cut_type, InitialEdgeCutType);
@@ -42,6 +49,9 @@ EdgeCut_Options *mex_get_options
     MEX_STRUCT_READBOOL(use_QP_gradproj);
     MEX_STRUCT_READDOUBLE(gradproj_tolerance);
     MEX_STRUCT_READINT(gradproj_iteration_limit);
+    MEX_STRUCT_READBOOL(gradproj_accelerate);
+    MEX_STRUCT_READINT(QP_band_depth);
+    MEX_STRUCT_READENUM(napsack_solver, NapsackSolver);
 
     /** Final Partition Target Metrics ***************************************/
     MEX_STRUCT_READDOUBLE(target_split);
@@ -50,38 +50,33 @@ cs *cs_mex_get_sparse (cs *A, csi square, csi values, const mxArray *Amatlab)
     return (A) ;
 }
 
-/* return a sparse matrix to MATLAB */
+/* return a sparse matrix to MATLAB. A is copied into MATLAB's memory, since
+   Mongoose's blocks can only be freed by mongoose_free, and is then freed */
 mxArray *cs_mex_put_sparse (cs **Ahandle)
 {
     cs *A ;
     mxArray *Amatlab ;
+    mwIndex *Ap, *Ai ;
+    double *Ax ;
+    csi j, p, nz ;
     if (!Ahandle || !CS_CSC ((*Ahandle))) mexErrMsgTxt ("invalid sparse matrix") ;
     A = *Ahandle ;
-    Amatlab = mxCreateSparse (0, 0, 0, mxREAL) ;
-    mxSetM (Amatlab, A->m) ;
-    mxSetN (Amatlab, A->n) ;
-    mxSetNzmax (Amatlab, A->nzmax) ;
-    SuiteSparse_free (mxGetJc (Amatlab)) ;
-    SuiteSparse_free (mxGetIr (Amatlab)) ;
-    mxSetJc (Amatlab, (mwIndex *) A->p) ;  /* assign A->p pointer to MATLAB A */
-    mxSetIr (Amatlab, (mwIndex *) A->i) ;
-    SuiteSparse_free (mxGetPr (Amatlab)) ;
-    if (A->x == NULL)
+    nz = A->p [A->n] ;
+    Amatlab = mxCreateSparse (A->m, A->n, (nz > 1) ? nz : 1, mxREAL) ;
+    Ap = mxGetJc (Amatlab) ;
+    Ai = mxGetIr (Amatlab) ;
+    Ax = mxGetPr (Amatlab) ;
+    for (j = 0 ; j <= A->n ; j++)
     {
-        /* A is a pattern only matrix; return all 1's to MATLAB */
-        csi i, nz ;
-        nz = A->p [A->n] ;
-        A->x = (double*) SuiteSparse_malloc ( (nz > 1) ? nz : 1, sizeof (double)) ;
-        for (i = 0 ; i < nz ; i++)
-        {
-            A->x [i] = 1 ;
-        }
+        Ap [j] = (mwIndex) A->p [j] ;
+    }
+    for (p = 0 ; p < nz ; p++)
+    {
+        Ai [p] = (mwIndex) A->i [p] ;
+        /* a pattern only matrix is returned to MATLAB as all 1's */
+        Ax [p] = (A->x == NULL) ? 1 : A->x [p] ;
     }
-    mxSetPr (Amatlab, A->x) ;
-    mexMakeMemoryPersistent (A->p) ;    /* ensure MATLAB does not free A->p */
-    mexMakeMemoryPersistent (A->i) ;
-    mexMakeMemoryPersistent (A->x) ;
-    SuiteSparse_free (A) ;              /* frees A struct only, not A->p, etc */
+    cs_spfree (A) ;
     *Ahandle = NULL ;
     return (Amatlab) ;
 }
@@ -113,7 +108,7 @@ Int *gp_mex_get_int
 )
 {
     double *p ;
-    Int i, k, *C = (Int*) SuiteSparse_malloc(n, sizeof (Int));
+    Int i, k, *C = (Int*) mongoose_malloc(n, sizeof (Int));
 
     p = mxGetPr (Imatlab) ;
     *imax = 0 ;
@@ -134,7 +129,7 @@ mxArray *gp_mex_put_int(Int *p, Int n, Int offset, Int do_free)
     double *x = mxGetPr (X) ;
     Int k ;
     for (k = 0 ; k < n ; k++) x [k] = (p ? p [k] : k) + offset ;
-    if (do_free) SuiteSparse_free(p);
+    if (do_free) mongoose_free(p);
     return (X) ;
 }
 
@@ -13,10 +13,17 @@ mxArray *mex_put_options
     mxArray *returner = mxCreateStructMatrix(1, 1, 0, NULL);
 
     MEX_STRUCT_PUT(random_seed);
+    MEX_STRUCT_PUT(collect_statistics);
+    MEX_STRUCT_PUT(memory_limit);
     MEX_STRUCT_PUT(coarsen_limit);
+    MEX_STRUCT_PUT(coarsen_min_shrink);
+    MEX_STRUCT_PUT(coarsen_max_levels);
     MEX_STRUCT_PUT(matching_strategy);
     MEX_STRUCT_PUT(do_community_matching);
     MEX_STRUCT_PUT(high_degree_threshold);
+    MEX_STRUCT_PUT(component_analysis);
+    MEX_STRUCT_PUT(vertex_ordering);
+    MEX_STRUCT_PUT(graph_reduction);
     
     /** Guess Partitioning Options *******************************************/
     MEX_STRUCT_PUT(initial_cut_type);
@@ -34,6 +41,9 @@ mxArray *mex_put_options
     MEX_STRUCT_PUT(use_QP_gradproj);
     MEX_STRUCT_PUT(gradproj_tolerance);
     MEX_STRUCT_PUT(gradproj_iteration_limit);
+    MEX_STRUCT_PUT(gradproj_accelerate);
+    MEX_STRUCT_PUT(QP_band_depth);
+    MEX_STRUCT_PUT(napsack_solver);
 
     /** Final Partition Target Metrics ***************************************/
     MEX_STRUCT_PUT(target_split);
@@ -35,7 +35,12 @@ flags = [flags ' -DGP_MEX_FUNCTION'] ;
 % Append optimization and 64-bit flags
 flags = [flags ' -DDLONG -O -silent COPTIMFLAGS="-O3 -fwrapv"'];
 
-cpp_flags = '' ;
+kernel_flags = flags ;
+if (isunix)
+    % Keep the QP kernels from using fused multiply-adds, so that they give
+    % the same result on every CPU
+    kernel_flags = [' CXXFLAGS="$CXXFLAGS -ffp-contract=off"' flags] ;
+end
 lib = '';
 if (isunix)
     if(~ismac)
@@ -56,16 +61,21 @@ config_src = {
 mongoose_src = {
     '../Source/Mongoose_BoundaryHeap', ...
     '../Source/Mongoose_Coarsening', ...
+    '../Source/Mongoose_Components', ...
     '../Source/Mongoose_CSparse', ...
     '../Source/Mongoose_EdgeCut', ...
     '../Source/Mongoose_EdgeCutOptions', ...
     '../Source/Mongoose_EdgeCutProblem', ...
+    '../Source/Mongoose_Generators', ...
     '../Source/Mongoose_Graph', ...
     '../Source/Mongoose_GuessCut', ...
     '../Source/Mongoose_ImproveFM', ...
     '../Source/Mongoose_ImproveQP', ...
     '../Source/Mongoose_Logger', ...
     '../Source/Mongoose_Matching', ...
+    '../Source/Mongoose_MemoryAccounting', ...
+    '../Source/Mongoose_Ordering', ...
+    '../Source/Mongoose_PerfCounters', ...
     '../Source/Mongoose_QPBoundary', ...
     '../Source/Mongoose_QPDelta', ...
     '../Source/Mongoose_QPGradProj', ...
@@ -74,10 +84,13 @@ mongoose_src = {
     '../Source/Mongoose_QPMaxHeap', ...
     '../Source/Mongoose_QPNapDown', ...
     '../Source/Mongoose_QPNapUp', ...
+    '../Source/Mongoose_QPNapSelect', ...
     '../Source/Mongoose_QPNapsack', ...
     '../Source/Mongoose_Random', ...
+    '../Source/Mongoose_Reduction', ...
     '../Source/Mongoose_Refinement', ...
     '../Source/Mongoose_Sanitize', ...
+    '../Source/Mongoose_Trace', ...
     '../Source/Mongoose_Waterdance' };
 
 mex_util_src = {
@@ -113,20 +126,23 @@ else
 
     % Compile Mongoose
     % fprintf('\n\nBuilding Mongoose');
-    obj_files = mex_compile(mongoose_src, 'cpp', [cpp_flags flags], include, details);
+    obj_files = mex_compile(mongoose_src, 'cpp', flags, include, details);
+    obj_list = [obj_list obj_files];
+    obj_files = mex_compile({'../Source/Mongoose_QPKernels'}, 'cpp', ...
+        kernel_flags, include, details);
     obj_list = [obj_list obj_files];
 end
     
 
 % fprintf('\nBuilding MEX Utilities') ;
 
-obj_files = mex_compile(mex_util_src, 'cpp', [cpp_flags flags], include, details);
+obj_files = mex_compile(mex_util_src, 'cpp', flags, include, details);
 obj_list = [obj_list obj_files];
 
 % fprintf('\nBuilding Mongoose MEX functions');
 kk = 1 ;
 for f = mongoose_mex_src
-    s = sprintf ('mex %s %s %s.cpp', [cpp_flags flags], include, f{1}) ;
+    s = sprintf ('mex %s %s %s.cpp', flags, include, f{1}) ;
     s = [s obj_list ' ' lib] ;  %#ok
     kk = do_cmd (s, kk, details) ;
 end
@@ -25,14 +25,10 @@ void mexFunction
     }
 
     const mxArray *A_matlab = pargin[0];
-    cs *A = (cs *) SuiteSparse_malloc(1, sizeof(cs));
-    A = cs_mex_get_sparse (A, 0, 1, A_matlab);
+    cs Amatrix;
+    cs *A = cs_mex_get_sparse (&Amatrix, 0, 1, A_matlab);
 
     cs *A_safe = sanitizeMatrix(A, false, makeBinary);
-    A->p = NULL;
-    A->i = NULL;
-    A->x = NULL;
-    cs_spfree(A);
 
     pargout[0] = cs_mex_put_sparse (&A_safe) ;
 }
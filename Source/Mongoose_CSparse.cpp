@@ -61,8 +61,8 @@ cs *cs_transpose(const cs *A, csi values)
     Ai = A->i;
     Ax = A->x;
     C  = cs_spalloc(n, m, Ap[n], values && Ax, 0); /* allocate result */
-    w  = (csi *)SuiteSparse_calloc(static_cast<size_t>(m),
-                                  sizeof(csi)); /* get workspace */
+    w  = (csi *)mongoose_calloc(static_cast<size_t>(m),
+                               sizeof(csi)); /* get workspace */
     if (!C || !w)
         return (cs_done(C, w, NULL, 0)); /* out of memory */
 
@@ -121,11 +121,11 @@ cs *cs_add(const cs *A, const cs *B, double alpha, double beta)
     Bp     = B->p;
     Bx     = B->x;
     bnz    = Bp[n];
-    w      = (csi *)SuiteSparse_calloc(static_cast<size_t>(m),
-                                  sizeof(csi)); /* get workspace */
+    w      = (csi *)mongoose_calloc(static_cast<size_t>(m),
+                               sizeof(csi)); /* get workspace */
     values = (A->x != NULL) && (Bx != NULL);
-    x      = values ? (double *)SuiteSparse_malloc(static_cast<size_t>(m),
-                                              sizeof(double))
+    x      = values ? (double *)mongoose_malloc(static_cast<size_t>(m),
+                                           sizeof(double))
                : NULL;                          /* get workspace */
     C = cs_spalloc(m, n, anz + bnz, values, 0); /* allocate result*/
     if (!C || !w || (values && !x))
@@ -175,8 +175,8 @@ cs *cs_compress(const cs *T)
     Tx = T->x;
     nz = T->nz;
     C  = cs_spalloc(m, n, nz, Tx != NULL, 0); /* allocate result */
-    w  = (csi *)SuiteSparse_calloc(static_cast<size_t>(n),
-                                  sizeof(csi)); /* get workspace */
+    w  = (csi *)mongoose_calloc(static_cast<size_t>(n),
+                               sizeof(csi)); /* get workspace */
     if (!C || !w)
         return (cs_done(C, w, NULL, 0)); /* out of memory */
     Cp = C->p;
@@ -261,18 +261,18 @@ csi cs_scatter(const cs *A, csi j, double beta, csi *w, double *x, csi mark,
 cs *cs_spalloc(csi m, csi n, csi nzmax, csi values, csi triplet)
 {
     cs *A
-        = (cs *)SuiteSparse_calloc(1, sizeof(cs)); /* allocate the cs struct */
+        = (cs *)mongoose_calloc(1, sizeof(cs)); /* allocate the cs struct */
     if (!A)
         return (NULL); /* out of memory */
     A->m     = m;      /* define dimensions and nzmax */
     A->n     = n;
     A->nzmax = nzmax = std::max(nzmax, (csi)1);
     A->nz            = triplet ? 0 : -1; /* allocate triplet or comp.col */
-    A->p             = (csi *)SuiteSparse_malloc(
+    A->p             = (csi *)mongoose_malloc(
         static_cast<size_t>(triplet ? nzmax : n + 1), sizeof(csi));
-    A->i = (csi *)SuiteSparse_malloc(static_cast<size_t>(nzmax), sizeof(csi));
-    A->x = values ? (double *)SuiteSparse_malloc(static_cast<size_t>(nzmax),
-                                                 sizeof(double))
+    A->i = (csi *)mongoose_malloc(static_cast<size_t>(nzmax), sizeof(csi));
+    A->x = values ? (double *)mongoose_malloc(static_cast<size_t>(nzmax),
+                                              sizeof(double))
                   : NULL;
     return ((!A->p || !A->i || (values && !A->x)) ? cs_spfree(A) : A);
 }
@@ -282,18 +282,18 @@ cs *cs_spfree(cs *A)
 {
     if (!A)
         return (NULL); /* do nothing if A already NULL */
-    SuiteSparse_free(A->p);
-    SuiteSparse_free(A->i);
-    SuiteSparse_free(A->x);
+    mongoose_free(A->p);
+    mongoose_free(A->i);
+    mongoose_free(A->x);
     return (
-        (cs *)SuiteSparse_free(A)); /* release the cs struct and return NULL */
+        (cs *)mongoose_free(A)); /* release the cs struct and return NULL */
 }
 
 /* release workspace and return a sparse matrix result */
 cs *cs_done(cs *C, void *w, void *x, csi ok)
 {
-    SuiteSparse_free(w); /* release workspace */
-    SuiteSparse_free(x);
+    mongoose_free(w); /* release workspace */
+    mongoose_free(x);
     return (ok ? C : cs_spfree(C)); /* return result if OK, else release it */
 }
 
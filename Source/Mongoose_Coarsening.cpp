@@ -22,6 +22,7 @@
 #include "Mongoose_Debug.hpp"
 #include "Mongoose_Internal.hpp"
 #include "Mongoose_Logger.hpp"
+#include "Mongoose_Ordering.hpp"
 
 namespace Mongoose
 {
@@ -31,11 +32,13 @@ namespace Mongoose
  *
  * Given a Graph @p G, coarsen returns a new Graph that is coarsened according
  * to the matching given by G->matching, G->matchmap, and G->invmatchmap.
- * G->matching must be built such that matching[a] = b+1 and matching[b] = a+1
- * if vertices a and b are matched. G->matchmap is a mapping from fine to coarse
- * vertices, so matchmap[a] = matchmap[b] = c if vertices a and b are matched
- * and mapped to vertex c in the coarse graph. Likewise, G->invmatchmap is
- * one possible inverse of G->matchmap, so invmatchmap[c] = a or
+ * G->matching must link the vertices matched together into a cycle, such that
+ * matching[a] = b+1 and matching[b] = a+1 if vertices a and b are matched
+ * (and matching[a] = a+1 if a is matched to itself). Clusters of more than
+ * two vertices form longer cycles. G->matchmap is a mapping from fine to
+ * coarse vertices, so matchmap[a] = matchmap[b] = c if vertices a and b are
+ * matched and mapped to vertex c in the coarse graph. Likewise, G->invmatchmap
+ * is one possible inverse of G->matchmap, so invmatchmap[c] = a or
  * invmatchmap[c] = b if a coarsened vertex c represents the matching of
  * vertices a and b in the refined graph.
  *
@@ -44,15 +47,18 @@ namespace Mongoose
  * @endcode
  *
  * @param graph Graph to be coarsened
- * @param options Option struct specifying if debug checks should be done
+ * @param options Option struct; if vertex_ordering is not natural, the coarse
+ *        vertices are numbered in the order of their fine vertices
  * @return A coarsened version of G
  * @note Allocates memory for the coarsened graph, but frees on error.
  */
 EdgeCutProblem *coarsen(EdgeCutProblem *graph, const EdgeCut_Options *options)
 {
-    (void)options; // Unused variable
+    Logger::tic(CoarseningTiming, graph->n);
 
-    Logger::tic(CoarseningTiming);
+    /* Keep the locality of a renumbered graph in the coarse graph */
+    if (options->vertex_ordering != VertexOrdering_Natural)
+        orderCoarseVertices(graph);
 
     Int cn     = graph->cn;
     Int *Gp    = graph->p;
@@ -66,13 +72,15 @@ EdgeCutProblem *coarsen(EdgeCutProblem *graph, const EdgeCut_Options *options)
     /* Build the coarse graph */
     EdgeCutProblem *coarseGraph = EdgeCutProblem::create(graph);
     if (!coarseGraph)
+    {
+        Logger::toc(CoarseningTiming);
         return NULL;
+    }
 
     Int *Cp       = coarseGraph->p;
     Int *Ci       = coarseGraph->i;
     double *Cx    = coarseGraph->x;
     double *Cw    = coarseGraph->w;
-    double *gains = coarseGraph->vertexGains;
     Int munch     = 0;
     double X      = 0.0;
 
@@ -82,44 +90,35 @@ EdgeCutProblem *coarsen(EdgeCutProblem *graph, const EdgeCut_Options *options)
 
     /* Hashtable stores column pointer values. */
     Int *htable
-        = (Int *)SuiteSparse_malloc(static_cast<size_t>(cn), sizeof(Int));
+        = (Int *)mongoose_malloc(static_cast<size_t>(cn), sizeof(Int));
     if (!htable)
     {
         coarseGraph->~EdgeCutProblem();
+        Logger::toc(CoarseningTiming);
         return NULL;
     }
     for (Int i = 0; i < cn; i++)
         htable[i] = -1;
 
+    /* # fine vertices of each match type, for the level statistics */
+    Int matchCount[4] = { 0, 0, 0, 0 };
+
     /* For each vertex in the coarse graph. */
     for (Int k = 0; k < cn; k++)
     {
-        /* Load up the inverse matching */
-        Int v[3] = { -1, -1, -1 };
-        v[0]     = invmatchmap[k];
-        v[1]     = graph->getMatch(v[0]);
-        if (v[0] == v[1])
-        {
-            v[1] = -1;
-        }
-        else
-        {
-            v[2] = graph->getMatch(v[1]);
-            if (v[0] == v[2])
-            {
-                v[2] = -1;
-            }
-        }
-
         Int ps = Cp[k] = munch; /* The munch start for this column */
 
         double vertexWeight   = 0.0;
         double sumEdgeWeights = 0.0;
-        for (Int i = 0; i < 3 && v[i] != -1; i++)
+
+        /* Walk the cycle of fine vertices matched into k */
+        Int first  = invmatchmap[k];
+        Int vertex = first;
+        do
         {
             /* Read the matched vertex and accumulate the vertex weight. */
-            Int vertex = v[i];
             vertexWeight += (Gw) ? Gw[vertex] : 1;
+            matchCount[graph->matchtype[vertex]]++;
 
             for (Int p = Gp[vertex]; p < Gp[vertex + 1]; p++)
             {
@@ -148,28 +147,44 @@ EdgeCutProblem *coarsen(EdgeCutProblem *graph, const EdgeCut_Options *options)
                     Cx[cp] += edgeWeight;
                 }
             }
-        }
+
+            vertex = graph->getMatch(vertex);
+        } while (vertex != first);
 
         /* Save the vertex weight. */
         Cw[k] = vertexWeight;
 
-        /* Save the sum of edge weights and initialize the gain for k. */
+        /* Save the sum of edge weights. */
         X += sumEdgeWeights;
-        gains[k] = -sumEdgeWeights;
     }
 
     /* Set the last column pointer */
     Cp[cn]          = munch;
     coarseGraph->nz = munch;
 
+    /* The edges were allocated for the fine graph; give back the rest. If
+     * shrinking fails, the larger arrays are kept. */
+    int ok = 1;
+    coarseGraph->i = (Int *)mongoose_realloc(
+        static_cast<size_t>(munch), static_cast<size_t>(graph->nz),
+        sizeof(Int), coarseGraph->i, &ok);
+    coarseGraph->x = (double *)mongoose_realloc(
+        static_cast<size_t>(munch), static_cast<size_t>(graph->nz),
+        sizeof(double), coarseGraph->x, &ok);
+
     /* Save the sum of edge weights on the graph. */
     coarseGraph->X = X;
     coarseGraph->H = 2.0 * X;
 
     coarseGraph->worstCaseRatio = graph->worstCaseRatio;
 
+    graph->stats.orphan_matches    = matchCount[MatchType_Orphan];
+    graph->stats.standard_matches  = matchCount[MatchType_Standard];
+    graph->stats.brotherly_matches = matchCount[MatchType_Brotherly];
+    graph->stats.community_matches = matchCount[MatchType_Community];
+
     /* Cleanup resources */
-    SuiteSparse_free(htable);
+    mongoose_free(htable);
 
 #ifndef NDEBUG
     /* If we want to do expensive checks, make sure we didn't break
@@ -0,0 +1,316 @@
+/* ========================================================================== */
+/* === Source/Mongoose_Components.cpp ======================================= */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+#include "Mongoose_Components.hpp"
+#include "Mongoose_EdgeCutProblem.hpp"
+#include "Mongoose_Logger.hpp"
+
+#include <algorithm>
+
+namespace Mongoose
+{
+
+/* Orders components by decreasing weight, breaking ties by number */
+struct ComponentHeavier
+{
+    const double *weight;
+    ComponentHeavier(const double *_weight) : weight(_weight) {}
+    bool operator()(Int a, Int b) const
+    {
+        return (weight[a] != weight[b]) ? (weight[a] > weight[b]) : (a < b);
+    }
+};
+
+/* Label each vertex with its connected component, numbered from 0 in order
+   of their lowest vertex, by breadth-first search. queue is workspace of
+   size n. Returns the number of components. */
+Int findComponents(const Graph *graph, Int *component, Int *queue)
+{
+    Int n   = graph->n;
+    Int *Gp = graph->p;
+    Int *Gi = graph->i;
+
+    for (Int k = 0; k < n; k++)
+        component[k] = -1;
+
+    Int numComponents = 0;
+    for (Int start = 0; start < n; start++)
+    {
+        if (component[start] >= 0)
+            continue;
+
+        Int head         = 0;
+        Int tail         = 0;
+        queue[tail++]    = start;
+        component[start] = numComponents;
+        while (head < tail)
+        {
+            Int v = queue[head++];
+            for (Int p = Gp[v]; p < Gp[v + 1]; p++)
+            {
+                Int u = Gi[p];
+                if (component[u] < 0)
+                {
+                    component[u]  = numComponents;
+                    queue[tail++] = u;
+                }
+            }
+        }
+        numComponents++;
+    }
+
+    return numComponents;
+}
+
+/* Partition a graph whose small components (fewer than coarsen_limit
+   vertices) are never cut. The small components are placed whole, heaviest
+   first, on whichever part is furthest below its target weight, so the
+   large components only need to supply what the small ones cannot. With a
+   lighter part target T and small components of total weight S, at most
+   c each, the large components are partitioned with target T - S + c
+   (leaving c for the packing to even out), or not cut at all if that is
+   not positive. */
+EdgeCut *edgeCutByComponents(const Graph *graph,
+                             const EdgeCut_Options *options)
+{
+    Int n      = graph->n;
+    Int *Gp    = graph->p;
+    Int *Gi    = graph->i;
+    double *Gx = graph->x;
+    double *Gw = graph->w;
+
+    Int *component = (Int *)mongoose_malloc(static_cast<size_t>(n),
+                                            sizeof(Int));
+    Int *map = (Int *)mongoose_malloc(static_cast<size_t>(n), sizeof(Int));
+    if (!component || !map)
+    {
+        mongoose_free(component);
+        mongoose_free(map);
+        return NULL;
+    }
+
+    Int numComponents = findComponents(graph, component, map);
+    size_t nc         = static_cast<size_t>(numComponents);
+
+    Int *compSize      = (Int *)mongoose_calloc(nc, sizeof(Int));
+    double *compWeight = (double *)mongoose_calloc(nc, sizeof(double));
+    Int *small         = (Int *)mongoose_malloc(nc, sizeof(Int));
+    if (!compSize || !compWeight || !small)
+    {
+        mongoose_free(component);
+        mongoose_free(map);
+        mongoose_free(compSize);
+        mongoose_free(compWeight);
+        mongoose_free(small);
+        return NULL;
+    }
+
+    for (Int k = 0; k < n; k++)
+    {
+        compSize[component[k]]++;
+        compWeight[component[k]] += (Gw) ? Gw[k] : 1;
+    }
+
+    Int numSmall = 0;
+    for (Int c = 0; c < numComponents; c++)
+    {
+        if (compSize[c] < options->coarsen_limit)
+            small[numSmall++] = c;
+    }
+
+    LogInfo("Graph has " << numComponents << " components, " << numSmall
+                         << " of them small\n");
+
+    if (numSmall == 0)
+    {
+        // Nothing to pack
+        mongoose_free(component);
+        mongoose_free(map);
+        mongoose_free(compSize);
+        mongoose_free(compWeight);
+        mongoose_free(small);
+        return edgeCutWhole(graph, options);
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* build the subgraph of the large components */
+    /* ---------------------------------------------------------------------- */
+
+    double smallWeight = 0;
+    double maxSmall    = 0;
+    double total       = 0;
+    for (Int c = 0; c < numComponents; c++)
+        total += compWeight[c];
+    for (Int s = 0; s < numSmall; s++)
+    {
+        smallWeight += compWeight[small[s]];
+        maxSmall = std::max(maxSmall, compWeight[small[s]]);
+    }
+    double targetSplit
+        = std::min(options->target_split, 1 - options->target_split);
+    double largeTarget = targetSplit * total - smallWeight + maxSmall;
+
+    Int nLarge  = 0;
+    Int nzLarge = 0;
+    for (Int k = 0; k < n; k++)
+    {
+        if (compSize[component[k]] >= options->coarsen_limit)
+        {
+            map[k] = nLarge++;
+            nzLarge += Gp[k + 1] - Gp[k];
+        }
+        else
+        {
+            map[k] = -1;
+        }
+    }
+
+    EdgeCut *largeCut = NULL;
+    bool ok           = true;
+    if (nLarge > 0 && largeTarget > 0)
+    {
+        EdgeCut_Options *largeOptions = EdgeCut_Options::create();
+        ok = (largeOptions != NULL);
+        if (largeOptions)
+        {
+            *largeOptions              = *options;
+            largeOptions->target_split = std::min(
+                largeTarget / (total - smallWeight), 0.5);
+        }
+
+        Graph *large = (ok) ? Graph::create(nLarge, nzLarge) : NULL;
+        if (large)
+        {
+            large->x = (Gx) ? (double *)mongoose_malloc(
+                           static_cast<size_t>(nzLarge), sizeof(double))
+                            : NULL;
+            large->w = (Gw) ? (double *)mongoose_malloc(
+                           static_cast<size_t>(nLarge), sizeof(double))
+                            : NULL;
+        }
+        ok = ok && large && (!Gx || large->x) && (!Gw || large->w);
+
+        if (ok)
+        {
+            Int nz = 0;
+            for (Int k = 0; k < n; k++)
+            {
+                if (map[k] < 0)
+                    continue;
+                large->p[map[k]] = nz;
+                for (Int p = Gp[k]; p < Gp[k + 1]; p++)
+                {
+                    // Neighbors are in the same component, so also large
+                    large->i[nz] = map[Gi[p]];
+                    if (Gx)
+                        large->x[nz] = Gx[p];
+                    nz++;
+                }
+                if (Gw)
+                    large->w[map[k]] = Gw[k];
+            }
+            large->p[nLarge] = nz;
+
+            largeCut = edgeCutWhole(large, largeOptions);
+            ok       = (largeCut != NULL);
+        }
+
+        if (large)
+            large->~Graph();
+        if (largeOptions)
+            largeOptions->~EdgeCut_Options();
+    }
+
+    EdgeCut *result = (ok) ? (EdgeCut *)mongoose_malloc(1, sizeof(EdgeCut))
+                           : NULL;
+    bool *partition
+        = (result) ? (bool *)mongoose_malloc(static_cast<size_t>(n),
+                                             sizeof(bool))
+                   : NULL;
+    if (!partition)
+    {
+        mongoose_free(result);
+        result = NULL;
+    }
+
+    if (result)
+    {
+        /* ------------------------------------------------------------------ */
+        /* pack the small components onto the part furthest from its target */
+        /* ------------------------------------------------------------------ */
+
+        // Uncut large components all go in part 1
+        double W[2] = { 0, 0 };
+        for (Int k = 0; k < n; k++)
+        {
+            if (map[k] >= 0)
+            {
+                partition[k] = (largeCut) ? largeCut->partition[map[k]] : true;
+                W[partition[k]] += (Gw) ? Gw[k] : 1;
+            }
+        }
+
+        // The lighter part so far aims for the smaller share of the weight
+        int lighter = (W[0] <= W[1]) ? 0 : 1;
+        double target[2];
+        target[lighter]     = targetSplit * total;
+        target[1 - lighter] = (1 - targetSplit) * total;
+
+        std::sort(small, small + numSmall, ComponentHeavier(compWeight));
+
+        // Reuse compSize to hold the part of each small component
+        Int *compPart = compSize;
+        for (Int s = 0; s < numSmall; s++)
+        {
+            Int c       = small[s];
+            int part    = (target[0] - W[0] >= target[1] - W[1]) ? 0 : 1;
+            compPart[c] = part;
+            W[part] += compWeight[c];
+        }
+        for (Int k = 0; k < n; k++)
+        {
+            if (map[k] < 0)
+                partition[k] = (compPart[component[k]] == 1);
+        }
+
+        result->partition = partition;
+        result->n         = n;
+        result->cut_cost  = (largeCut) ? largeCut->cut_cost : 0;
+        result->cut_size  = (largeCut) ? largeCut->cut_size : 0;
+        result->w0        = W[0];
+        result->w1        = W[1];
+        result->imbalance = (total > 0) ? fabs(options->target_split
+                                               - std::min(W[0], W[1]) / total)
+                                        : 0;
+
+        result->gradproj_iterations
+            = (largeCut) ? largeCut->gradproj_iterations : 0;
+
+        /* The statistics are those of the subgraph of large components */
+        result->levels     = (largeCut) ? largeCut->levels : NULL;
+        result->num_levels = (largeCut) ? largeCut->num_levels : 0;
+        result->peak_memory = (largeCut) ? largeCut->peak_memory : -1;
+        if (largeCut)
+            largeCut->levels = NULL;
+    }
+
+    if (largeCut)
+        largeCut->~EdgeCut();
+    mongoose_free(component);
+    mongoose_free(map);
+    mongoose_free(compSize);
+    mongoose_free(compWeight);
+    mongoose_free(small);
+
+    return result;
+}
+
+} // end namespace Mongoose
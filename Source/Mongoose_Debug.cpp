@@ -249,9 +249,19 @@ void QPcheckCom(EdgeCutProblem *G, const EdgeCut_Options *O, QPDelta *QP, bool c
 
     /* check that grad is correct */
 
+    /* a band QP adds a constant offset to the gradient, and so twice the
+       offset times x to the cost */
+    double *offset = QP->gradientOffset;
+    double newcost = 0.;
     for (j = 0; j < n; j++)
+    {
         gtemp[j] = (.5 - x[j]) * D[j];
-    double newcost = 0.;
+        if (offset)
+        {
+            gtemp[j] += offset[j];
+            newcost += 2 * offset[j] * x[j];
+        }
+    }
     if (Ex == NULL)
     {
         for (j = 0; j < n; j++)
@@ -301,9 +311,10 @@ void QPcheckCom(EdgeCutProblem *G, const EdgeCut_Options *O, QPDelta *QP, bool c
         ERROR;
     }
 
-    /* check that cost decreases */
+    /* check that cost decreases (the offset of a band QP can make it
+       negative) */
 
-    if (newcost / QP->check_cost > (1 + tol))
+    if (newcost > QP->check_cost + tol * fabs(QP->check_cost))
     {
         PR(("cost increases, old %30.15e new %30.15e\n", QP->check_cost,
             newcost));
@@ -12,10 +12,13 @@
 #include "Mongoose_EdgeCut.hpp"
 #include "Mongoose_EdgeCutProblem.hpp"
 #include "Mongoose_Coarsening.hpp"
+#include "Mongoose_Components.hpp"
 #include "Mongoose_GuessCut.hpp"
 #include "Mongoose_Internal.hpp"
 #include "Mongoose_Logger.hpp"
+#include "Mongoose_Ordering.hpp"
 #include "Mongoose_Random.hpp"
+#include "Mongoose_Reduction.hpp"
 #include "Mongoose_Refinement.hpp"
 #include "Mongoose_Waterdance.hpp"
 
@@ -26,11 +29,77 @@ namespace Mongoose
 
 bool optionsAreValid(const EdgeCut_Options *options);
 void cleanup(EdgeCutProblem *graph);
+void freeQPWorkspace(EdgeCutProblem *graph);
+
+/* Copy the statistics of a level into the list returned with the cut */
+inline void saveLevelStatistics(EdgeCutProblem *graph, EdgeCut_Level *levels)
+{
+    EdgeCut_Level *level    = &levels[graph->clevel];
+    *level                  = graph->stats;
+    level->n                = graph->n;
+    level->nz               = graph->nz;
+    level->coarsening_ratio = (graph->parent) ? static_cast<double>(graph->n)
+                                                    / static_cast<double>(
+                                                        graph->parent->n)
+                                              : 1;
+
+    /* The cut cost counts each cut edge twice until cleanup */
+    level->cut_before_FM /= 2;
+    level->cut_after_FM /= 2;
+    level->cut_after_QP /= 2;
+
+    if (!MemoryAccounting::isOn())
+        level->peak_memory = -1;
+}
+
+/* Charge the peak memory of a part of the work on a level to that level */
+inline void saveLevelPeak(EdgeCutProblem *graph, Int outerPeak, Int memoryBase)
+{
+    Int peak = MemoryAccounting::stopPeak(outerPeak) - memoryBase;
+    graph->stats.peak_memory = std::max(graph->stats.peak_memory, peak);
+}
+
+/* Free the coarse levels built on top of a problem, after a failure */
+static void freeCoarseLevels(EdgeCutProblem *current, EdgeCutProblem *problem)
+{
+    while (current != problem)
+    {
+        EdgeCutProblem *next = current->parent;
+        current->~EdgeCutProblem();
+        current = next;
+    }
+    freeQPWorkspace(problem);
+}
+
+/* A copy of the options, to be adjusted to fit options->memory_limit */
+static EdgeCut_Options *copyOptions(const EdgeCut_Options *options)
+{
+    EdgeCut_Options *copy = EdgeCut_Options::create();
+    if (copy)
+        *copy = *options;
+    return copy;
+}
+
+/* Bytes the QP needs beside the levels: the shared workspace and, if only a
+   band is optimized, a band problem up to the size of the graph */
+static double qpEstimate(const EdgeCutProblem *problem,
+                         const EdgeCut_Options *options)
+{
+    size_t bytes = QPDelta::memoryEstimate(problem->n);
+    if (options->QP_band_depth > 0)
+        bytes += EdgeCutProblem::memoryEstimate(problem->n, problem->nz, true);
+    return static_cast<double>(bytes);
+}
+
+static EdgeCut *guessAndRefine(EdgeCutProblem *problem, EdgeCutProblem *current,
+                               const EdgeCut_Options *options,
+                               Int memoryBase, Int outerPeak);
 
 EdgeCut::~EdgeCut()
 {
-    SuiteSparse_free(partition);
-    SuiteSparse_free(this);
+    mongoose_free(partition);
+    mongoose_free(levels);
+    mongoose_free(this);
 }
 
 EdgeCut *edge_cut(const Graph *graph)
@@ -59,6 +128,60 @@ EdgeCut *edge_cut(const Graph *graph, const EdgeCut_Options *options)
     if (!graph)
         return NULL;
 
+    /*
+     * Under a memory limit, skip the preprocessing that partitions a copy of
+     * the graph: the copy is kept for the whole cut.
+     */
+    if (options->memory_limit > 0
+        && (options->component_analysis || options->graph_reduction
+            || options->vertex_ordering != VertexOrdering_Natural))
+    {
+        EdgeCut_Options *fitted = copyOptions(options);
+        if (!fitted)
+            return NULL;
+
+        LogInfo("Graph copies skipped to fit options->memory_limit\n");
+        fitted->component_analysis = false;
+        fitted->graph_reduction    = false;
+        fitted->vertex_ordering    = VertexOrdering_Natural;
+
+        EdgeCut *result = edge_cut(graph, fitted);
+        fitted->~EdgeCut_Options();
+        return result;
+    }
+
+    // Count the memory used if statistics are requested
+    bool accounting = options->collect_statistics && !MemoryAccounting::isOn();
+    if (accounting)
+        MemoryAccounting::setAccountingFlag(true);
+    Int memoryBase = MemoryAccounting::inUse();
+    Int outerPeak  = MemoryAccounting::startPeak();
+
+    // Set aside the small connected components
+    EdgeCut *result = (options->component_analysis)
+                          ? edgeCutByComponents(graph, options)
+                          : edgeCutWhole(graph, options);
+
+    Int peak = MemoryAccounting::stopPeak(outerPeak) - memoryBase;
+    if (result)
+        result->peak_memory = (MemoryAccounting::isOn()) ? peak : -1;
+    if (accounting)
+        MemoryAccounting::setAccountingFlag(false);
+
+    return result;
+}
+
+/* Partition the whole graph with the multilevel algorithm */
+EdgeCut *edgeCutWhole(const Graph *graph, const EdgeCut_Options *options)
+{
+    // Fold leaves and merge twins
+    if (options->graph_reduction)
+        return edgeCutReduced(graph, options);
+
+    // Renumber the graph for locality
+    if (options->vertex_ordering != VertexOrdering_Natural)
+        return edgeCutOrdered(graph, options);
+
     // Create an EdgeCutProblem
     EdgeCutProblem *problem = EdgeCutProblem::create(graph);
 
@@ -83,63 +206,245 @@ EdgeCut *edge_cut(EdgeCutProblem *problem, const EdgeCut_Options *options)
     if (!problem)
         return NULL;
 
+    /*
+     * Under a memory limit, keep count of the bytes held by the levels (and
+     * their statistics and the result), and of the most they need once the
+     * partition arrays of the level being refined are allocated. If even the
+     * graph does not fit, there is nothing cheaper to fall back to.
+     */
+    double limit      = options->memory_limit;
+    double levelStats = (options->collect_statistics)
+                            ? static_cast<double>(sizeof(EdgeCut_Level))
+                            : 0;
+    double held = (limit > 0) ? static_cast<double>(
+                                    problem->memoryUsage() + sizeof(EdgeCut)
+                                    + sizeof(EdgeCut_Options))
+                                    + levelStats
+                              : 0;
+    double need = held + static_cast<double>(
+                             EdgeCutProblem::refinementEstimate(problem->n));
+    if (limit > 0 && need > limit)
+    {
+        LogError("Fatal Error: the graph needs more memory than "
+                 "options->memory_limit allows.");
+        return NULL;
+    }
+
+    /*
+     * While memory accounting is on, the peak memory of the work on each
+     * level is kept with its statistics, relative to the memory in use now.
+     */
+    Int memoryBase = MemoryAccounting::inUse();
+    Int outerPeak  = MemoryAccounting::startPeak();
+
     /* Finish initialization */
     problem->initialize(options);
 
+    /*
+     * Allocate a single QP workspace, sized for the finest graph, that is
+     * shared by every level. If this fails, improveCutUsingQP falls back to
+     * allocating its own workspace on each call. Under a memory limit, this
+     * waits until it is known whether the workspace fits.
+     */
+    problem->qpWorkspace = (options->use_QP_gradproj && limit == 0)
+                               ? QPDelta::Create(problem->n)
+                               : NULL;
+
     /* Keep track of what the current graph is at any stage */
     EdgeCutProblem *current = problem;
 
     /* If we need to coarsen the graph, do the coarsening. */
     while (current->n >= options->coarsen_limit)
     {
+        if (options->coarsen_max_levels > 0
+            && current->clevel >= options->coarsen_max_levels)
+        {
+            LogInfo("Coarsening stopped after " << current->clevel
+                                                << " levels\n");
+            break;
+        }
+
+        /* Leave room for the workspace of matching */
+        if (limit > 0
+            && held + 5.0 * sizeof(Int) * static_cast<double>(current->n)
+                   > limit)
+        {
+            LogInfo("Coarsening stopped at level "
+                    << current->clevel << " to fit options->memory_limit\n");
+            break;
+        }
+
+        Logger::setTimingLevel(current->clevel);
+        Int levelPeak = MemoryAccounting::startPeak();
         match(current, options);
+
+        /*
+         * Under a memory limit, build the coarse level only if it fits beside
+         * the partition arrays this level gets when the cut is projected back
+         * onto it.
+         */
+        if (limit > 0)
+        {
+            double coarse = static_cast<double>(
+                EdgeCutProblem::memoryEstimate(current->cn, current->nz, true)
+                + EdgeCutProblem::refinementEstimate(current->n)
+                + static_cast<size_t>(current->cn) * sizeof(Int))
+                + levelStats;
+            if (held + coarse > limit)
+            {
+                saveLevelPeak(current, levelPeak, memoryBase);
+                LogInfo("Coarsening stopped at level "
+                        << current->clevel
+                        << " to fit options->memory_limit\n");
+                break;
+            }
+            need = std::max(need, held + coarse);
+        }
+
         EdgeCutProblem *next = coarsen(current, options);
+        saveLevelPeak(current, levelPeak, memoryBase);
 
         /* If we ran out of memory during coarsening, unwind the stack. */
         if (!next)
         {
-            while (current != problem)
-            {
-                next = current->parent;
-                current->~EdgeCutProblem();
-                current = next;
-            }
+            MemoryAccounting::stopPeak(outerPeak);
+            freeCoarseLevels(current, problem);
+            Logger::setTimingLevel(0);
             return NULL;
         }
 
         current = next;
+        held += static_cast<double>(current->memoryUsage()) + levelStats;
+
+        /* Stop if even two-hop matching could not shrink the graph enough */
+        if (static_cast<double>(current->n)
+            > (1 - options->coarsen_min_shrink)
+                  * static_cast<double>(current->parent->n))
+        {
+            LogInfo("Coarsening stalled at level " << current->clevel << " ("
+                                                   << current->n
+                                                   << " vertices)\n");
+            break;
+        }
     }
 
     /*
-     * Generate a guess cut and do FM refinement.
-     * On failure, unwind the stack.
+     * Under a memory limit, the QP workspace is allocated only if it fits
+     * beside the most memory the levels need while they are refined. If not,
+     * the QP is skipped, and a QP guess cut is replaced by a random one.
      */
-    if (!guessCut(current, options))
+    EdgeCut_Options *fitted = NULL;
+    if (limit > 0 && options->use_QP_gradproj)
     {
-        while (current != problem)
+        QPDelta *workspace = (need + qpEstimate(problem, options) <= limit)
+                                 ? QPDelta::Create(problem->n)
+                                 : NULL;
+        if (workspace)
         {
-            EdgeCutProblem *next = current->parent;
-            current->~EdgeCutProblem();
-            current = next;
+            for (EdgeCutProblem *level = current; level; level = level->parent)
+                level->qpWorkspace = workspace;
         }
+        else
+        {
+            fitted = copyOptions(options);
+            if (!fitted)
+            {
+                MemoryAccounting::stopPeak(outerPeak);
+                freeCoarseLevels(current, problem);
+                Logger::setTimingLevel(0);
+                return NULL;
+            }
+
+            LogInfo("QP skipped to fit options->memory_limit\n");
+            fitted->use_QP_gradproj = false;
+            if (fitted->initial_cut_type == InitialEdgeCut_QP)
+                fitted->initial_cut_type = InitialEdgeCut_Random;
+        }
+    }
+
+    EdgeCut *result = guessAndRefine(problem, current,
+                                     (fitted) ? fitted : options, memoryBase,
+                                     outerPeak);
+    if (fitted)
+        fitted->~EdgeCut_Options();
+
+    return result;
+}
+
+/*
+ * Guess a cut of the coarsest level and refine it back to the problem. On
+ * failure, the coarse levels are freed.
+ */
+static EdgeCut *guessAndRefine(EdgeCutProblem *problem, EdgeCutProblem *current,
+                               const EdgeCut_Options *options,
+                               Int memoryBase, Int outerPeak)
+{
+    /*
+     * Allocate the partition arrays of the coarsest level, generate a guess
+     * cut and do FM refinement. On failure, unwind the stack.
+     */
+    Logger::setTimingLevel(current->clevel);
+    Int levelPeak = MemoryAccounting::startPeak();
+    bool guessed  = current->allocateRefinementArrays()
+                   && guessCut(current, options);
+    saveLevelPeak(current, levelPeak, memoryBase);
+    if (!guessed)
+    {
+        MemoryAccounting::stopPeak(outerPeak);
+        Logger::setTimingLevel(0);
+        freeCoarseLevels(current, problem);
         return NULL;
     }
 
+    /*
+     * If requested, keep the statistics of each level before it is freed.
+     * Statistics are optional, so running out of memory here is not fatal.
+     */
+    Int numLevels = current->clevel + 1;
+    EdgeCut_Level *levels
+        = (options->collect_statistics)
+              ? (EdgeCut_Level *)mongoose_malloc(
+                    static_cast<size_t>(numLevels), sizeof(EdgeCut_Level))
+              : NULL;
+
     /*
      * Refine the guess cut back to the beginning.
      */
     while (current->parent != NULL)
     {
-        current = refine(current, options);
+        if (levels)
+            saveLevelStatistics(current, levels);
+        Logger::setTimingLevel(current->parent->clevel);
+        levelPeak               = MemoryAccounting::startPeak();
+        EdgeCutProblem *refined = refine(current, options);
+
+        /* If we ran out of memory projecting the cut, unwind the stack. */
+        if (!refined)
+        {
+            MemoryAccounting::stopPeak(levelPeak);
+            MemoryAccounting::stopPeak(outerPeak);
+            Logger::setTimingLevel(0);
+            mongoose_free(levels);
+            freeCoarseLevels(current, problem);
+            return NULL;
+        }
+
+        current = refined;
         waterdance(current, options);
+        saveLevelPeak(current, levelPeak, memoryBase);
     }
+    if (levels)
+        saveLevelStatistics(current, levels);
 
+    freeQPWorkspace(current);
     cleanup(current);
 
-    EdgeCut *result = (EdgeCut*)SuiteSparse_malloc(1, sizeof(EdgeCut));
+    EdgeCut *result = (EdgeCut*)mongoose_malloc(1, sizeof(EdgeCut));
+    Int peak        = MemoryAccounting::stopPeak(outerPeak) - memoryBase;
 
     if (!result)
     {
+        mongoose_free(levels);
         return NULL;
     }
 
@@ -152,6 +457,13 @@ EdgeCut *edge_cut(EdgeCutProblem *problem, const EdgeCut_Options *options)
     result->w1        = current->W1;
     result->imbalance = current->imbalance;
 
+    result->gradproj_iterations = current->gradprojIterations;
+
+    result->levels     = levels;
+    result->num_levels = (levels) ? numLevels : 0;
+
+    result->peak_memory = (MemoryAccounting::isOn()) ? peak : -1;
+
     return result;
 }
 
@@ -163,12 +475,33 @@ bool optionsAreValid(const EdgeCut_Options *options)
         return (false);
     }
 
+    if (options->memory_limit < 0)
+    {
+        LogError("Fatal Error: options->memory_limit cannot be less than "
+                 "zero.");
+        return (false);
+    }
+
     if (options->coarsen_limit < 1)
     {
         LogError("Fatal Error: options->coarsen_limit cannot be less than one.");
         return (false);
     }
 
+    if (options->coarsen_min_shrink < 0 || options->coarsen_min_shrink >= 1)
+    {
+        LogError("Fatal Error: options->coarsen_min_shrink must be in the "
+                 "range [0, 1).");
+        return (false);
+    }
+
+    if (options->coarsen_max_levels < 0)
+    {
+        LogError("Fatal Error: options->coarsen_max_levels cannot be less "
+                 "than zero.");
+        return (false);
+    }
+
     if (options->high_degree_threshold < 0)
     {
         LogError("Fatal Error: options->high_degree_threshold cannot be less "
@@ -217,6 +550,13 @@ bool optionsAreValid(const EdgeCut_Options *options)
         return (false);
     }
 
+    if (options->QP_band_depth < 0)
+    {
+        LogError("Fatal Error: options->QP_band_depth cannot be less than "
+                 "zero.");
+        return (false);
+    }
+
     if (options->target_split < 0 || options->target_split > 1)
     {
         LogError(
@@ -251,4 +591,14 @@ void cleanup(EdgeCutProblem *G)
     G->cutCost   = G->cutCost / 2;
 }
 
+void freeQPWorkspace(EdgeCutProblem *graph)
+{
+    if (graph->qpWorkspace)
+    {
+        graph->qpWorkspace->~QPDelta();
+        mongoose_free(graph->qpWorkspace);
+        graph->qpWorkspace = NULL;
+    }
+}
+
 } // end namespace Mongoose
@@ -19,16 +19,23 @@ namespace Mongoose
 EdgeCut_Options *EdgeCut_Options::create()
 {
     EdgeCut_Options *ret
-        = static_cast<EdgeCut_Options *>(SuiteSparse_malloc(1, sizeof(EdgeCut_Options)));
+        = static_cast<EdgeCut_Options *>(mongoose_malloc(1, sizeof(EdgeCut_Options)));
 
     if (ret != NULL)
     {
         ret->random_seed = 0;
+        ret->collect_statistics = false;
+        ret->memory_limit       = 0;
 
         ret->coarsen_limit        = 64;
+        ret->coarsen_min_shrink   = 0.05;
+        ret->coarsen_max_levels   = 64;
         ret->matching_strategy    = HEMSR;
         ret->do_community_matching = false;
         ret->high_degree_threshold = 2.0;
+        ret->component_analysis    = false;
+        ret->vertex_ordering       = VertexOrdering_Natural;
+        ret->graph_reduction       = false;
 
         ret->initial_cut_type = InitialEdgeCut_Random;
 
@@ -42,6 +49,9 @@ EdgeCut_Options *EdgeCut_Options::create()
         ret->use_QP_gradproj          = true;
         ret->gradproj_tolerance      = 0.001;
         ret->gradproj_iteration_limit = 50;
+        ret->gradproj_accelerate      = false;
+        ret->QP_band_depth            = 0;
+        ret->napsack_solver           = NapsackSolver_Heap;
 
         ret->target_split        = 0.5;
         ret->soft_split_tolerance = 0;
@@ -52,7 +62,7 @@ EdgeCut_Options *EdgeCut_Options::create()
 
 EdgeCut_Options::~EdgeCut_Options()
 {
-    SuiteSparse_free(this);
+    mongoose_free(this);
 }
 
 } // end namespace Mongoose
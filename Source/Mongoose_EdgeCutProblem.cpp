@@ -50,6 +50,11 @@ EdgeCutProblem::EdgeCutProblem()
     invmatchmap = NULL;
     matchtype   = NULL;
 
+    qpWorkspace        = NULL;
+    gradprojIterations = 0;
+
+    stats = EdgeCut_Level();
+
     markArray = NULL;
     markValue = 1;
 }
@@ -57,7 +62,7 @@ EdgeCutProblem::EdgeCutProblem()
 EdgeCutProblem *EdgeCutProblem::create(const Int _n, const Int _nz, Int *_p,
                                        Int *_i, double *_x, double *_w)
 {
-    void *memoryLocation = SuiteSparse_malloc(1, sizeof(EdgeCutProblem));
+    void *memoryLocation = mongoose_malloc(1, sizeof(EdgeCutProblem));
     if (!memoryLocation)
         return NULL;
 
@@ -77,9 +82,9 @@ EdgeCutProblem *EdgeCutProblem::create(const Int _n, const Int _nz, Int *_p,
 
     graph->p = (graph->shallow_p)
                ? _p
-               : (Int *)SuiteSparse_calloc(n + 1, sizeof(Int));
+               : (Int *)mongoose_calloc(n + 1, sizeof(Int));
     graph->i
-        = (graph->shallow_i) ? _i : (Int *)SuiteSparse_malloc(nz, sizeof(Int));
+        = (graph->shallow_i) ? _i : (Int *)mongoose_malloc(nz, sizeof(Int));
     graph->x = _x;
     graph->w = _w;
     graph->X = 0.0;
@@ -91,19 +96,9 @@ EdgeCutProblem *EdgeCutProblem::create(const Int _n, const Int _nz, Int *_p,
         return NULL;
     }
 
-    graph->partition      = (bool *)SuiteSparse_malloc(n, sizeof(bool));
-    graph->vertexGains    = (double *)SuiteSparse_malloc(n, sizeof(double));
-    graph->externalDegree = (Int *)SuiteSparse_calloc(n, sizeof(Int));
-    graph->bhIndex        = (Int *)SuiteSparse_calloc(n, sizeof(Int));
-    graph->bhHeap[0]      = (Int *)SuiteSparse_malloc(n, sizeof(Int));
-    graph->bhHeap[1]      = (Int *)SuiteSparse_malloc(n, sizeof(Int));
+    /* The partition arrays are allocated only once the graph is partitioned
+     * (see allocateRefinementArrays). */
     graph->bhSize[0] = graph->bhSize[1] = 0;
-    if (!graph->partition || !graph->vertexGains || !graph->externalDegree
-        || !graph->bhIndex || !graph->bhHeap[0] || !graph->bhHeap[1])
-    {
-        graph->~EdgeCutProblem();
-        return NULL;
-    }
 
     graph->heuCost   = 0.0;
     graph->cutCost   = 0.0;
@@ -114,15 +109,14 @@ EdgeCutProblem *EdgeCutProblem::create(const Int _n, const Int _nz, Int *_p,
     graph->parent      = NULL;
     graph->clevel      = 0;
     graph->cn          = 0;
-    graph->matching    = (Int *)SuiteSparse_calloc(n, sizeof(Int));
-    graph->matchmap    = (Int *)SuiteSparse_malloc(n, sizeof(Int));
-    graph->invmatchmap = (Int *)SuiteSparse_malloc(n, sizeof(Int));
-    graph->matchtype   = (Int *)SuiteSparse_malloc(n, sizeof(Int));
-    graph->markArray   = (Int *)SuiteSparse_calloc(n, sizeof(Int));
+    graph->matching    = (Int *)mongoose_calloc(n, sizeof(Int));
+    graph->matchmap    = (Int *)mongoose_malloc(n, sizeof(Int));
+    graph->invmatchmap = (Int *)mongoose_malloc(n, sizeof(Int));
+    graph->matchtype   = (Int *)mongoose_malloc(n, sizeof(Int));
     graph->markValue   = 1;
     graph->singleton   = -1;
     if (!graph->matching || !graph->matchmap || !graph->invmatchmap
-        || !graph->markArray || !graph->matchtype)
+        || !graph->matchtype)
     {
         graph->~EdgeCutProblem();
         return NULL;
@@ -148,8 +142,8 @@ EdgeCutProblem *EdgeCutProblem::create(EdgeCutProblem *_parent)
     if (!graph)
         return NULL;
 
-    graph->x = (double *)SuiteSparse_malloc(_parent->nz, sizeof(double));
-    graph->w = (double *)SuiteSparse_malloc(_parent->cn, sizeof(double));
+    graph->x = (double *)mongoose_malloc(_parent->nz, sizeof(double));
+    graph->w = (double *)mongoose_malloc(_parent->cn, sizeof(double));
 
     if (!graph->x || !graph->w)
     {
@@ -161,30 +155,34 @@ EdgeCutProblem *EdgeCutProblem::create(EdgeCutProblem *_parent)
     graph->parent = _parent;
     graph->clevel = graph->parent->clevel + 1;
 
+    /* Coarse graphs are never larger than their parent, so they can share
+     * the parent's QP workspace. */
+    graph->qpWorkspace = _parent->qpWorkspace;
+
     return graph;
 }
 
 EdgeCutProblem::~EdgeCutProblem()
 {
-    p = (shallow_p) ? NULL : (Int *)SuiteSparse_free(p);
-    i = (shallow_i) ? NULL : (Int *)SuiteSparse_free(i);
-    x = (shallow_x) ? NULL : (double *)SuiteSparse_free(x);
-    w = (shallow_w) ? NULL : (double *)SuiteSparse_free(w);
-
-    partition      = (bool *)SuiteSparse_free(partition);
-    vertexGains    = (double *)SuiteSparse_free(vertexGains);
-    externalDegree = (Int *)SuiteSparse_free(externalDegree);
-    bhIndex        = (Int *)SuiteSparse_free(bhIndex);
-    bhHeap[0]      = (Int *)SuiteSparse_free(bhHeap[0]);
-    bhHeap[1]      = (Int *)SuiteSparse_free(bhHeap[1]);
-    matching       = (Int *)SuiteSparse_free(matching);
-    matchmap       = (Int *)SuiteSparse_free(matchmap);
-    invmatchmap    = (Int *)SuiteSparse_free(invmatchmap);
-    matchtype      = (Int *)SuiteSparse_free(matchtype);
-
-    markArray = (Int *)SuiteSparse_free(markArray);
-
-    SuiteSparse_free(this);
+    p = (shallow_p) ? NULL : (Int *)mongoose_free(p);
+    i = (shallow_i) ? NULL : (Int *)mongoose_free(i);
+    x = (shallow_x) ? NULL : (double *)mongoose_free(x);
+    w = (shallow_w) ? NULL : (double *)mongoose_free(w);
+
+    partition      = (bool *)mongoose_free(partition);
+    vertexGains    = (double *)mongoose_free(vertexGains);
+    externalDegree = (Int *)mongoose_free(externalDegree);
+    bhIndex        = (Int *)mongoose_free(bhIndex);
+    bhHeap[0]      = (Int *)mongoose_free(bhHeap[0]);
+    bhHeap[1]      = (Int *)mongoose_free(bhHeap[1]);
+    matching       = (Int *)mongoose_free(matching);
+    matchmap       = (Int *)mongoose_free(matchmap);
+    invmatchmap    = (Int *)mongoose_free(invmatchmap);
+    matchtype      = (Int *)mongoose_free(matchtype);
+
+    markArray = (Int *)mongoose_free(markArray);
+
+    mongoose_free(this);
 }
 
 /* Initialize a top level graph with a a set of options. */
@@ -211,23 +209,26 @@ void EdgeCutProblem::initialize(const EdgeCut_Options *options)
 
         clevel = 0;
         cn     = 0;
+
+        gradprojIterations = 0;
+
+        stats = EdgeCut_Level();
+
         for (Int k = 0; k < n; k++)
         {
-            externalDegree[k] = 0;
-            bhIndex[k]        = 0;
-            matching[k]       = 0;
+            matching[k] = 0;
         }
         singleton = -1;
 
-        clearMarkArray();
+        releaseRefinementArrays();
     }
 
     Int *Gp    = p;
     double *Gx = x;
     double *Gw = w;
 
-    /* Compute worst-case gains, and compute X. */
-    double *gains = vertexGains;
+    /* Compute X. The worst-case gains are computed along with the partition
+     * arrays, once the graph is refined. */
     double min    = fabs((Gx) ? Gx[0] : 1);
     double max    = fabs((Gx) ? Gx[0] : 1);
     for (Int k = 0; k < n; k++)
@@ -250,7 +251,6 @@ void EdgeCutProblem::initialize(const EdgeCut_Options *options)
             }
         }
 
-        gains[k] = -sumEdgeWeights;
         X += sumEdgeWeights;
     }
     H = 2.0 * X;
@@ -261,6 +261,135 @@ void EdgeCutProblem::initialize(const EdgeCut_Options *options)
     initialized = true;
 }
 
+/**
+ * The bytes allocated for a graph of n vertices and nz edges, once its
+ * partition arrays are allocated.
+ *
+ * If ownsGraph is false, the adjacency and weights are shared with the caller
+ * (as for the input graph) and not counted.
+ */
+size_t EdgeCutProblem::memoryEstimate(Int _n, Int _nz, bool ownsGraph)
+{
+    size_t n     = static_cast<size_t>(_n);
+    size_t nz    = static_cast<size_t>(_nz);
+    size_t bytes = sizeof(EdgeCutProblem) + 4 * n * sizeof(Int)
+                   + refinementEstimate(_n);
+    if (ownsGraph)
+    {
+        bytes += (n + 1 + nz) * sizeof(Int) + (nz + n) * sizeof(double);
+    }
+    return bytes;
+}
+
+/* The bytes allocated by allocateRefinementArrays for a graph of n vertices */
+size_t EdgeCutProblem::refinementEstimate(Int _n)
+{
+    return static_cast<size_t>(_n)
+           * (sizeof(bool) + sizeof(double) + 5 * sizeof(Int));
+}
+
+/* The bytes currently allocated by this graph */
+size_t EdgeCutProblem::memoryUsage() const
+{
+    size_t N     = static_cast<size_t>(n);
+    size_t bytes = sizeof(EdgeCutProblem);
+
+    if (!shallow_p && p)
+        bytes += (N + 1) * sizeof(Int);
+    if (!shallow_i && i)
+        bytes += static_cast<size_t>(nz) * sizeof(Int);
+    if (!shallow_x && x)
+        bytes += static_cast<size_t>(nz) * sizeof(double);
+    if (!shallow_w && w)
+        bytes += N * sizeof(double);
+
+    if (partition)
+        bytes += N * sizeof(bool);
+    if (vertexGains)
+        bytes += N * sizeof(double);
+
+    const Int *arrays[] = { externalDegree, bhIndex,   bhHeap[0],
+                            bhHeap[1],      markArray, matching,
+                            matchmap,       invmatchmap, matchtype };
+    for (size_t k = 0; k < sizeof(arrays) / sizeof(Int *); k++)
+    {
+        if (arrays[k])
+            bytes += N * sizeof(Int);
+    }
+
+    return bytes;
+}
+
+/**
+ * Free the arrays used only by partitioning and refinement.
+ *
+ * Matching and coarsening do not touch the partition, gains, boundary heap or
+ * mark array, so a level holds them only from the time a cut is guessed or
+ * projected onto it (see allocateRefinementArrays).
+ */
+void EdgeCutProblem::releaseRefinementArrays()
+{
+    partition      = (bool *)mongoose_free(partition);
+    vertexGains    = (double *)mongoose_free(vertexGains);
+    externalDegree = (Int *)mongoose_free(externalDegree);
+    bhIndex        = (Int *)mongoose_free(bhIndex);
+    bhHeap[0]      = (Int *)mongoose_free(bhHeap[0]);
+    bhHeap[1]      = (Int *)mongoose_free(bhHeap[1]);
+    bhSize[0] = bhSize[1] = 0;
+    markArray = (Int *)mongoose_free(markArray);
+    markValue = 1;
+}
+
+/**
+ * Allocate the arrays used by partitioning and refinement, with no boundary,
+ * nothing marked and the worst-case gains.
+ *
+ * @return false if out of memory, in which case the arrays are released.
+ */
+bool EdgeCutProblem::allocateRefinementArrays()
+{
+    if (hasRefinementArrays())
+        return true;
+
+    size_t N       = static_cast<size_t>(n);
+    partition      = (bool *)mongoose_malloc(N, sizeof(bool));
+    vertexGains    = (double *)mongoose_malloc(N, sizeof(double));
+    externalDegree = (Int *)mongoose_calloc(N, sizeof(Int));
+    bhIndex        = (Int *)mongoose_calloc(N, sizeof(Int));
+    bhHeap[0]      = (Int *)mongoose_malloc(N, sizeof(Int));
+    bhHeap[1]      = (Int *)mongoose_malloc(N, sizeof(Int));
+    if (!partition || !vertexGains || !externalDegree || !bhIndex
+        || !bhHeap[0] || !bhHeap[1] || !allocateMarkArray())
+    {
+        releaseRefinementArrays();
+        return false;
+    }
+
+    for (Int k = 0; k < n; k++)
+    {
+        double sumEdgeWeights = 0.0;
+        for (Int j = p[k]; j < p[k + 1]; j++)
+        {
+            sumEdgeWeights += (x) ? x[j] : 1;
+        }
+        vertexGains[k] = -sumEdgeWeights;
+    }
+
+    return true;
+}
+
+/* Allocate the mark array alone, with nothing marked, if not yet allocated */
+bool EdgeCutProblem::allocateMarkArray()
+{
+    if (!markArray)
+    {
+        markArray = (Int *)mongoose_calloc(static_cast<size_t>(n),
+                                           sizeof(Int));
+        markValue = 1;
+    }
+    return (markArray != NULL);
+}
+
 void EdgeCutProblem::clearMarkArray()
 {
     markValue += 1;
@@ -0,0 +1,521 @@
+/* ========================================================================== */
+/* === Source/Mongoose_Generators.cpp ======================================= */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+#include "Mongoose_Generators.hpp"
+#include "Mongoose_Logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+namespace Mongoose
+{
+
+/* A small generator (splitmix64) with its own state, so that a seed gives
+   the same graph on every platform and does not disturb Mongoose::random */
+struct GeneratorRandom
+{
+    uint64_t state;
+
+    explicit GeneratorRandom(Int seed) : state(static_cast<uint64_t>(seed))
+    {
+    }
+
+    uint64_t next()
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z          = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    /* Uniform in [0, 1) */
+    double uniform()
+    {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    /* Uniform in [0, n) */
+    Int below(Int n)
+    {
+        return static_cast<Int>(next() % static_cast<uint64_t>(n));
+    }
+};
+
+/* The largest number of vertices or edges a generator will attempt */
+static const double MaxGeneratedSize = 4.0e18;
+
+/* === Structured grids and meshes ========================================= */
+
+/* Build the graph of a 3D stencil on an nx-by-ny-by-nz box: the 6 face
+   neighbors of each point, or all 26 neighbors if full is set. The first
+   pass counts the edges, the second fills them in, in increasing order. */
+static Graph *generateStencil(Int nx, Int ny, Int nz, bool full)
+{
+    if (nx < 1 || ny < 1 || nz < 1
+        || static_cast<double>(nx) * static_cast<double>(ny)
+                   * static_cast<double>(nz) * (full ? 27 : 7)
+               > MaxGeneratedSize)
+    {
+        LogError("Error: Invalid grid dimensions\n");
+        return NULL;
+    }
+    Int n = nx * ny * nz;
+
+    Graph *graph = NULL;
+    Int *Gp      = NULL;
+    Int *Gi      = NULL;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        Int nnz = 0;
+        for (Int z = 0; z < nz; z++)
+        {
+            for (Int y = 0; y < ny; y++)
+            {
+                for (Int x = 0; x < nx; x++)
+                {
+                    if (pass == 1)
+                        Gp[x + nx * (y + ny * z)] = nnz;
+                    for (Int dz = -1; dz <= 1; dz++)
+                    {
+                        Int zz = z + dz;
+                        if (zz < 0 || zz >= nz)
+                            continue;
+                        for (Int dy = -1; dy <= 1; dy++)
+                        {
+                            Int yy = y + dy;
+                            if (yy < 0 || yy >= ny)
+                                continue;
+                            for (Int dx = -1; dx <= 1; dx++)
+                            {
+                                Int xx       = x + dx;
+                                Int distance = std::abs(dx) + std::abs(dy)
+                                               + std::abs(dz);
+                                if (xx < 0 || xx >= nx || distance == 0
+                                    || (!full && distance > 1))
+                                    continue;
+                                if (pass == 1)
+                                    Gi[nnz] = xx + nx * (yy + ny * zz);
+                                nnz++;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        if (pass == 0)
+        {
+            graph = Graph::create(n, nnz);
+            if (!graph)
+                return NULL;
+            Gp = graph->p;
+            Gi = graph->i;
+        }
+        else
+        {
+            Gp[n] = nnz;
+        }
+    }
+
+    return graph;
+}
+
+Graph *generate_grid(Int nx, Int ny, Int nz)
+{
+    return generateStencil(nx, ny, nz, false);
+}
+
+Graph *generate_mesh(Int nx, Int ny, Int nz)
+{
+    return generateStencil(nx, ny, nz, true);
+}
+
+/* === Random graphs ======================================================== */
+
+/* Build a graph from the m undirected edges (eu[e], ev[e]), dropping
+   self-edges and duplicate edges. eu and ev are freed. */
+static Graph *graphFromEdges(Int n, Int m, Int *eu, Int *ev)
+{
+    Graph *graph = Graph::create(n, 2 * m);
+    Int *next    = (Int *)mongoose_malloc(static_cast<size_t>(n),
+                                          sizeof(Int));
+    if (!graph || !next)
+    {
+        if (graph)
+            graph->~Graph();
+        mongoose_free(next);
+        mongoose_free(eu);
+        mongoose_free(ev);
+        return NULL;
+    }
+    Int *Gp = graph->p;
+    Int *Gi = graph->i;
+
+    /* Count the entries of each column, and place them */
+    for (Int e = 0; e < m; e++)
+    {
+        if (eu[e] != ev[e])
+        {
+            Gp[eu[e]]++;
+            Gp[ev[e]]++;
+        }
+    }
+    Int sum = 0;
+    for (Int k = 0; k < n; k++)
+    {
+        Int count = Gp[k];
+        Gp[k]     = sum;
+        next[k]   = sum;
+        sum += count;
+    }
+    Gp[n] = sum;
+    for (Int e = 0; e < m; e++)
+    {
+        if (eu[e] != ev[e])
+        {
+            Gi[next[eu[e]]++] = ev[e];
+            Gi[next[ev[e]]++] = eu[e];
+        }
+    }
+    mongoose_free(eu);
+    mongoose_free(ev);
+
+    /* Drop duplicate edges, compacting the columns in place */
+    Int *mark = next;
+    for (Int k = 0; k < n; k++)
+        mark[k] = -1;
+    Int nz = 0;
+    for (Int k = 0; k < n; k++)
+    {
+        Int start = Gp[k];
+        Int end   = Gp[k + 1];
+        Gp[k]     = nz;
+        for (Int p = start; p < end; p++)
+        {
+            Int j = Gi[p];
+            if (mark[j] != k)
+            {
+                mark[j]  = k;
+                Gi[nz++] = j;
+            }
+        }
+    }
+    Gp[n]     = nz;
+    graph->nz = nz;
+    mongoose_free(mark);
+
+    /* Give back the space of the dropped edges (keep it if that fails) */
+    int ok = 1;
+    Gi     = (Int *)mongoose_realloc(static_cast<size_t>(nz),
+                                 static_cast<size_t>(2 * m), sizeof(Int),
+                                 Gi, &ok);
+    if (ok)
+        graph->i = Gi;
+
+    return graph;
+}
+
+/* Allocate the endpoints of m edges */
+static bool allocateEdges(Int m, Int **eu, Int **ev)
+{
+    *eu = (Int *)mongoose_malloc(static_cast<size_t>(m), sizeof(Int));
+    *ev = (Int *)mongoose_malloc(static_cast<size_t>(m), sizeof(Int));
+    if (!*eu || !*ev)
+    {
+        mongoose_free(*eu);
+        mongoose_free(*ev);
+        return false;
+    }
+    return true;
+}
+
+Graph *generate_erdos_renyi(Int n, double degree, Int seed)
+{
+    double edges = static_cast<double>(n) * degree / 2;
+    if (n < 1 || degree < 0 || edges > MaxGeneratedSize)
+    {
+        LogError("Error: Invalid Erdos-Renyi graph size\n");
+        return NULL;
+    }
+    Int m = (n > 1) ? static_cast<Int>(edges + 0.5) : 0;
+
+    Int *eu, *ev;
+    if (!allocateEdges(m, &eu, &ev))
+        return NULL;
+
+    GeneratorRandom rng(seed);
+    for (Int e = 0; e < m; e++)
+    {
+        eu[e] = rng.below(n);
+        do
+        {
+            ev[e] = rng.below(n);
+        } while (ev[e] == eu[e]);
+    }
+
+    return graphFromEdges(n, m, eu, ev);
+}
+
+Graph *generate_rmat(Int scale, Int edgeFactor, Int seed)
+{
+    if (scale < 0 || scale > 60 || edgeFactor < 0
+        || std::ldexp(static_cast<double>(edgeFactor), static_cast<int>(scale))
+               > MaxGeneratedSize)
+    {
+        LogError("Error: Invalid R-MAT graph size\n");
+        return NULL;
+    }
+    Int n = static_cast<Int>(1) << scale;
+    Int m = edgeFactor * n;
+
+    /* The Graph500 quadrant probabilities a, a + b, a + b + c (d = 0.05),
+       in units of 2^-16 */
+    const uint64_t a = 37355, ab = 49807, abc = 62259;
+
+    /* Permute the vertices, so that degree does not follow the numbering */
+    Int *perm = (Int *)mongoose_malloc(static_cast<size_t>(n), sizeof(Int));
+    Int *eu, *ev;
+    if (!perm || !allocateEdges(m, &eu, &ev))
+    {
+        mongoose_free(perm);
+        return NULL;
+    }
+    GeneratorRandom rng(seed);
+    for (Int k = 0; k < n; k++)
+        perm[k] = k;
+    for (Int k = n - 1; k > 0; k--)
+    {
+        Int j   = rng.below(k + 1);
+        Int t   = perm[k];
+        perm[k] = perm[j];
+        perm[j] = t;
+    }
+
+    /* Each level picks a quadrant with 16 random bits, 4 levels per draw */
+    for (Int e = 0; e < m; e++)
+    {
+        Int u = 0, v = 0;
+        uint64_t bits = 0;
+        for (Int bit = 0; bit < scale; bit++)
+        {
+            if (bit % 4 == 0)
+                bits = rng.next();
+            uint64_t r = bits & 0xFFFF;
+            bits >>= 16;
+            u = 2 * u + (r >= ab);
+            v = 2 * v + ((r >= a && r < ab) || r >= abc);
+        }
+        eu[e] = perm[u];
+        ev[e] = perm[v];
+    }
+    mongoose_free(perm);
+
+    return graphFromEdges(n, m, eu, ev);
+}
+
+/* Join the n points (px, py) closer than radius. The points are sorted into
+   g-by-g cells at least radius wide (with their coordinates copied to sx and
+   sy in the same order), so only the 3-by-3 cells around each point are
+   searched; the cells of a row are contiguous. */
+static Graph *joinPoints(Int n, const double *px, const double *py,
+                         double radius, Int g, Int *cellOf, Int *cellStart,
+                         Int *cellPoints, double *sx, double *sy)
+{
+    Int ncells = g * g;
+    for (Int k = 0; k < n; k++)
+    {
+        Int cx    = std::min(static_cast<Int>(px[k] * g), g - 1);
+        Int cy    = std::min(static_cast<Int>(py[k] * g), g - 1);
+        cellOf[k] = cx + g * cy;
+        cellStart[cellOf[k] + 1]++;
+    }
+    for (Int c = 0; c < ncells; c++)
+        cellStart[c + 1] += cellStart[c];
+    for (Int k = 0; k < n; k++)
+    {
+        Int q         = cellStart[cellOf[k]]++;
+        cellPoints[q] = k;
+        sx[q]         = px[k];
+        sy[q]         = py[k];
+    }
+    for (Int c = ncells; c > 0; c--)
+        cellStart[c] = cellStart[c - 1];
+    cellStart[0] = 0;
+
+    /* Visit the points cell by cell, so that the cells searched are mostly
+       in cache. The first pass counts the degree of each point (in next),
+       the second places its neighbors in its column. */
+    Int *next      = cellOf;
+    double radius2 = radius * radius;
+    Graph *graph   = NULL;
+    Int *Gi        = NULL;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (Int cy = 0; cy < g; cy++)
+        {
+            for (Int cx = 0; cx < g; cx++)
+            {
+                Int c = cx + g * cy;
+                for (Int q = cellStart[c]; q < cellStart[c + 1]; q++)
+                {
+                    Int k  = cellPoints[q];
+                    Int dk = 0;
+                    for (Int y = std::max(cy - 1, (Int)0);
+                         y <= std::min(cy + 1, g - 1); y++)
+                    {
+                        Int first = cellStart[std::max(cx - 1, (Int)0) + g * y];
+                        Int last = cellStart[std::min(cx + 1, g - 1) + g * y + 1];
+                        for (Int r = first; r < last; r++)
+                        {
+                            double dx = sx[r] - sx[q];
+                            double dy = sy[r] - sy[q];
+                            if (dx * dx + dy * dy >= radius2 || r == q)
+                                continue;
+                            if (pass == 1)
+                                Gi[next[k]++] = cellPoints[r];
+                            dk++;
+                        }
+                    }
+                    if (pass == 0)
+                        next[k] = dk;
+                }
+            }
+        }
+
+        if (pass == 0)
+        {
+            Int nnz = 0;
+            for (Int k = 0; k < n; k++)
+                nnz += next[k];
+            graph = Graph::create(n, nnz);
+            if (!graph)
+                return NULL;
+            Int *Gp = graph->p;
+            Gi      = graph->i;
+            Int sum = 0;
+            for (Int k = 0; k < n; k++)
+            {
+                Gp[k] = sum;
+                sum += next[k];
+                next[k] = Gp[k];
+            }
+            Gp[n] = sum;
+        }
+    }
+
+    return graph;
+}
+
+Graph *generate_geometric(Int n, double degree, Int seed)
+{
+    if (n < 1 || degree < 0
+        || static_cast<double>(n) * (degree + 1) > MaxGeneratedSize)
+    {
+        LogError("Error: Invalid geometric graph size\n");
+        return NULL;
+    }
+
+    /* An expected degree of n * pi * r^2, ignoring the boundary */
+    const double pi = 3.14159265358979323846;
+    double radius   = std::sqrt(degree / (pi * static_cast<double>(n)));
+
+    /* Cells at least radius wide, and about one point per cell or more */
+    double cells = std::sqrt(static_cast<double>(n)) + 1;
+    if (radius > 0)
+        cells = std::min(cells, std::floor(1 / radius));
+    Int g = std::max(static_cast<Int>(cells), static_cast<Int>(1));
+
+    size_t nn   = static_cast<size_t>(n);
+    double *px  = (double *)mongoose_malloc(nn, sizeof(double));
+    double *py  = (double *)mongoose_malloc(nn, sizeof(double));
+    Int *cellOf = (Int *)mongoose_malloc(nn, sizeof(Int));
+    Int *cellStart
+        = (Int *)mongoose_calloc(static_cast<size_t>(g * g + 1), sizeof(Int));
+    Int *cellPoints = (Int *)mongoose_malloc(nn, sizeof(Int));
+    double *sx      = (double *)mongoose_malloc(nn, sizeof(double));
+    double *sy      = (double *)mongoose_malloc(nn, sizeof(double));
+
+    Graph *graph = NULL;
+    if (px && py && cellOf && cellStart && cellPoints && sx && sy)
+    {
+        GeneratorRandom rng(seed);
+        for (Int k = 0; k < n; k++)
+        {
+            px[k] = rng.uniform();
+            py[k] = rng.uniform();
+        }
+        graph = joinPoints(n, px, py, radius, g, cellOf, cellStart, cellPoints,
+                           sx, sy);
+    }
+
+    mongoose_free(px);
+    mongoose_free(py);
+    mongoose_free(cellOf);
+    mongoose_free(cellStart);
+    mongoose_free(cellPoints);
+    mongoose_free(sx);
+    mongoose_free(sy);
+    return graph;
+}
+
+/* === Specifications ======================================================= */
+
+Graph *generate_graph(const std::string &spec)
+{
+    return generate_graph(spec.c_str());
+}
+
+Graph *generate_graph(const char *spec)
+{
+    const char *colon = (spec) ? strchr(spec, ':') : NULL;
+    if (!colon)
+    {
+        LogError("Error: Invalid graph specification\n");
+        return NULL;
+    }
+
+    char *end;
+    Int size = static_cast<Int>(strtoll(colon + 1, &end, 10));
+    Int seed = 1;
+    bool ok  = (end != colon + 1);
+    if (ok && *end == ':')
+    {
+        const char *s = end + 1;
+        seed          = static_cast<Int>(strtoll(s, &end, 10));
+        ok            = (end != s);
+    }
+    ok = ok && (*end == '\0');
+
+    std::string kind(spec, static_cast<size_t>(colon - spec));
+    if (ok && kind == "grid2d")
+        return generate_grid(size, size, 1);
+    if (ok && kind == "grid3d")
+        return generate_grid(size, size, size);
+    if (ok && kind == "mesh2d")
+        return generate_mesh(size, size, 1);
+    if (ok && kind == "mesh3d")
+        return generate_mesh(size, size, size);
+    if (ok && kind == "geometric")
+        return generate_geometric(size, 8, seed);
+    if (ok && kind == "er")
+        return generate_erdos_renyi(size, 8, seed);
+    if (ok && kind == "rmat")
+        return generate_rmat(size, 16, seed);
+
+    LogError("Error: Invalid graph specification " << std::string(spec)
+                                                   << "\n");
+    return NULL;
+}
+
+} // end namespace Mongoose
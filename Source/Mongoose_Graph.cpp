@@ -14,6 +14,10 @@
 #include <algorithm>
 #include <new>
 
+#ifdef MONGOOSE_HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 namespace Mongoose
 {
 
@@ -25,12 +29,15 @@ Graph::Graph()
     i      = NULL;
     x      = NULL;
     w      = NULL;
+
+    mapping     = NULL;
+    mappingSize = 0;
 }
 
 Graph *Graph::create(const Int _n, const Int _nz, Int *_p, Int *_i, double *_x,
                      double *_w)
 {
-    void *memoryLocation = SuiteSparse_malloc(1, sizeof(Graph));
+    void *memoryLocation = mongoose_malloc(1, sizeof(Graph));
     if (!memoryLocation)
         return NULL;
 
@@ -50,9 +57,9 @@ Graph *Graph::create(const Int _n, const Int _nz, Int *_p, Int *_i, double *_x,
 
     graph->p = (graph->shallow_p)
                    ? _p
-                   : (Int *)SuiteSparse_calloc(n + 1, sizeof(Int));
+                   : (Int *)mongoose_calloc(n + 1, sizeof(Int));
     graph->i
-        = (graph->shallow_i) ? _i : (Int *)SuiteSparse_malloc(nz, sizeof(Int));
+        = (graph->shallow_i) ? _i : (Int *)mongoose_malloc(nz, sizeof(Int));
     graph->x = _x;
     graph->w = _w;
 
@@ -81,7 +88,7 @@ Graph *Graph::create(cs *matrix)
 
 Graph *Graph::create(cs *matrix, bool free_when_done)
 {
-    void *memoryLocation = SuiteSparse_malloc(1, sizeof(Graph));
+    void *memoryLocation = mongoose_malloc(1, sizeof(Graph));
     if (!memoryLocation)
         return NULL;
 
@@ -102,18 +109,29 @@ Graph *Graph::create(cs *matrix, bool free_when_done)
     graph->shallow_p = !free_when_done;
     graph->shallow_i = !free_when_done;
     graph->shallow_x = !free_when_done;
+    graph->shallow_w = false;
 
     return graph;
 }
 
 Graph::~Graph()
 {
-    p = (shallow_p) ? NULL : (Int *)SuiteSparse_free(p);
-    i = (shallow_i) ? NULL : (Int *)SuiteSparse_free(i);
-    x = (shallow_x) ? NULL : (double *)SuiteSparse_free(x);
-    w = (shallow_w) ? NULL : (double *)SuiteSparse_free(w);
+    p = (shallow_p) ? NULL : (Int *)mongoose_free(p);
+    i = (shallow_i) ? NULL : (Int *)mongoose_free(i);
+    x = (shallow_x) ? NULL : (double *)mongoose_free(x);
+    w = (shallow_w) ? NULL : (double *)mongoose_free(w);
+
+    if (mapping)
+    {
+#ifdef MONGOOSE_HAVE_MMAP
+        munmap(mapping, mappingSize);
+#else
+        mongoose_free(mapping);
+#endif
+        mapping = NULL;
+    }
 
-    SuiteSparse_free(this);
+    mongoose_free(this);
 }
 
 } // end namespace Mongoose
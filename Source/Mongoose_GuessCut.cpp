@@ -12,6 +12,7 @@
 #include "Mongoose_GuessCut.hpp"
 #include "Mongoose_ImproveQP.hpp"
 #include "Mongoose_Internal.hpp"
+#include "Mongoose_Logger.hpp"
 #include "Mongoose_Random.hpp"
 #include "Mongoose_Waterdance.hpp"
 
@@ -23,6 +24,7 @@ namespace Mongoose
 //-----------------------------------------------------------------------------
 bool guessCut(EdgeCutProblem *graph, const EdgeCut_Options *options)
 {
+    Logger::tic(GuessCutTiming, graph->n);
     switch (options->initial_cut_type)
     {
     case InitialEdgeCut_QP:
@@ -35,6 +37,7 @@ bool guessCut(EdgeCutProblem *graph, const EdgeCut_Options *options)
         bhLoad(graph, options);
         if (!improveCutUsingQP(graph, options, true))
         {
+            Logger::toc(GuessCutTiming);
             return false;
             // Error - QP Failure
         }
@@ -59,6 +62,7 @@ bool guessCut(EdgeCutProblem *graph, const EdgeCut_Options *options)
     /* Do the waterdance refinement. */
     waterdance(graph, options);
 
+    Logger::toc(GuessCutTiming);
     return true;
 }
 
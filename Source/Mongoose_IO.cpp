@@ -22,8 +22,24 @@
 #include "Mongoose_Internal.hpp"
 #include "Mongoose_Logger.hpp"
 #include "Mongoose_Sanitize.hpp"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
+#ifdef MONGOOSE_HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <atomic>
+#include <sstream>
+#endif
+
+#ifdef _WIN32
+#include <process.h>
+#endif
+
 using namespace std;
 
 namespace Mongoose
@@ -34,6 +50,31 @@ Graph *read_graph(const std::string &filename)
     return read_graph(filename.c_str());
 }
 
+bool write_graph_binary(const Graph *graph, const std::string &filename)
+{
+    return write_graph_binary(graph, filename.c_str());
+}
+
+Graph *read_graph(const std::string &filename, bool use_cache)
+{
+    return read_graph(filename.c_str(), use_cache);
+}
+
+Graph *read_graph_streaming(const std::string &filename)
+{
+    return read_graph_streaming(filename.c_str());
+}
+
+Graph *read_graph_metis(const std::string &filename)
+{
+    return read_graph_metis(filename.c_str());
+}
+
+Graph *read_graph_binary(const std::string &filename)
+{
+    return read_graph_binary(filename.c_str());
+}
+
 cs *read_matrix(const std::string &filename, MM_typecode &matcode)
 {
     return read_matrix(filename.c_str(), matcode);
@@ -41,6 +82,15 @@ cs *read_matrix(const std::string &filename, MM_typecode &matcode)
 
 Graph *read_graph(const char *filename)
 {
+    if (isBinaryGraphFile(filename))
+    {
+        return read_graph_binary(filename);
+    }
+    if (hasExtension(filename, ".graph"))
+    {
+        return read_graph_metis(filename);
+    }
+
     Logger::tic(IOTiming);
     LogInfo("Reading graph from file " << std::string(filename) << "\n");
 
@@ -117,17 +167,17 @@ cs *read_matrix(const char *filename, MM_typecode &matcode)
     }
 
     LogInfo("Reading matrix data...\n");
-    Int *I = (Int *)SuiteSparse_malloc(static_cast<size_t>(nz), sizeof(Int));
-    Int *J = (Int *)SuiteSparse_malloc(static_cast<size_t>(nz), sizeof(Int));
+    Int *I = (Int *)mongoose_malloc(static_cast<size_t>(nz), sizeof(Int));
+    Int *J = (Int *)mongoose_malloc(static_cast<size_t>(nz), sizeof(Int));
     double *val
-        = (double *)SuiteSparse_malloc(static_cast<size_t>(nz), sizeof(double));
+        = (double *)mongoose_malloc(static_cast<size_t>(nz), sizeof(double));
 
     if (!I || !J || !val)
     {
         LogError("Error: Ran out of memory in Mongoose::read_matrix\n");
-        SuiteSparse_free(I);
-        SuiteSparse_free(J);
-        SuiteSparse_free(val);
+        mongoose_free(I);
+        mongoose_free(J);
+        mongoose_free(val);
         fclose(file);
         return NULL;
     }
@@ -143,13 +193,13 @@ cs *read_matrix(const char *filename, MM_typecode &matcode)
             val[k] = 1;
     }
 
-    cs *A = (cs *)SuiteSparse_malloc(1, sizeof(cs));
+    cs *A = (cs *)mongoose_malloc(1, sizeof(cs));
     if (!A)
     {
         LogError("Error: Ran out of memory in Mongoose::read_matrix\n");
-        SuiteSparse_free(I);
-        SuiteSparse_free(J);
-        SuiteSparse_free(val);
+        mongoose_free(I);
+        mongoose_free(J);
+        mongoose_free(val);
         return NULL;
     }
 
@@ -173,4 +223,968 @@ cs *read_matrix(const char *filename, MM_typecode &matcode)
     return compressed_A;
 }
 
+bool hasExtension(const char *filename, const char *extension)
+{
+    size_t length          = strlen(filename);
+    size_t extensionLength = strlen(extension);
+    return length >= extensionLength
+           && strcmp(filename + length - extensionLength, extension) == 0;
+}
+
+/* ========================================================================== */
+/* === METIS graph files ==================================================== */
+/* ========================================================================== */
+
+/* Skip blanks. Returns false at the end of the line (or file). */
+inline bool skipBlanks(const char **s)
+{
+    while (**s == ' ' || **s == '\t' || **s == '\r')
+        (*s)++;
+    return (**s != '\n' && **s != '\0');
+}
+
+/* Read a nonnegative integer from the current line */
+inline bool parseInt(const char **s, Int *value)
+{
+    if (!skipBlanks(s) || **s < '0' || **s > '9')
+        return false;
+    Int v = 0;
+    for (; **s >= '0' && **s <= '9'; (*s)++)
+        v = 10 * v + (**s - '0');
+    *value = v;
+    return true;
+}
+
+/* Read a number from the current line */
+inline bool parseDouble(const char **s, double *value)
+{
+    if (!skipBlanks(s))
+        return false;
+    char *next;
+    *value = strtod(*s, &next);
+    if (next == *s)
+        return false;
+    *s = next;
+    return true;
+}
+
+/* Returns the start of the next line that is not a comment, or NULL */
+inline const char *nextDataLine(const char *s, bool first)
+{
+    if (!first)
+    {
+        s = strchr(s, '\n');
+        if (!s)
+            return NULL;
+        s++;
+    }
+    while (*s == '%')
+    {
+        s = strchr(s, '\n');
+        if (!s)
+            return NULL;
+        s++;
+    }
+    return (*s) ? s : NULL;
+}
+
+Graph *read_graph_metis(const char *filename)
+{
+    Logger::tic(IOTiming);
+    LogInfo("Reading METIS graph from file " << std::string(filename) << "\n");
+
+    /* ---------------------------------------------------------------------- */
+    /* read the whole file */
+    /* ---------------------------------------------------------------------- */
+
+    FILE *file = fopen(filename, "rb");
+    long fileSize = -1;
+    if (file && fseek(file, 0, SEEK_END) == 0)
+    {
+        fileSize = ftell(file);
+        rewind(file);
+    }
+    if (fileSize < 0)
+    {
+        LogError("Error: Cannot read file " << std::string(filename) << "\n");
+        if (file)
+            fclose(file);
+        Logger::toc(IOTiming);
+        return NULL;
+    }
+
+    size_t size  = static_cast<size_t>(fileSize);
+    char *buffer = (char *)mongoose_malloc(size + 1, sizeof(char));
+    if (!buffer || fread(buffer, 1, size, file) != size)
+    {
+        LogError("Error: Cannot read file " << std::string(filename) << "\n");
+        mongoose_free(buffer);
+        fclose(file);
+        Logger::toc(IOTiming);
+        return NULL;
+    }
+    fclose(file);
+    buffer[size] = '\0';
+
+    /* ---------------------------------------------------------------------- */
+    /* parse the header: n m [fmt [ncon]] */
+    /* ---------------------------------------------------------------------- */
+
+    const char *s = nextDataLine(buffer, true);
+    Int n = -1, m = -1, fmt = 0, ncon = 1;
+    if (s && parseInt(&s, &n) && parseInt(&s, &m) && parseInt(&s, &fmt))
+    {
+        parseInt(&s, &ncon);
+    }
+    bool hasSizes         = (fmt / 100) % 10 == 1;
+    bool hasVertexWeights = (fmt / 10) % 10 == 1;
+    bool hasEdgeWeights   = fmt % 10 == 1;
+    if (n < 0 || m < 0 || skipBlanks(&s) || fmt % 10 > 1 || (fmt / 10) % 10 > 1
+        || fmt / 100 > 1)
+    {
+        LogError("Error: Could not parse METIS header\n");
+        mongoose_free(buffer);
+        Logger::toc(IOTiming);
+        return NULL;
+    }
+    if (hasVertexWeights && ncon != 1)
+    {
+        LogError("Error: Multiple vertex weights are not supported\n");
+        mongoose_free(buffer);
+        Logger::toc(IOTiming);
+        return NULL;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* parse the adjacency lists */
+    /* ---------------------------------------------------------------------- */
+
+    // The header promises 2m entries; grow if the file holds more.
+    Int nzmax = std::max(2 * m, (Int)1);
+    cs *A     = cs_spalloc(n, n, nzmax, hasEdgeWeights, 0);
+    double *w = (hasVertexWeights)
+                    ? (double *)mongoose_malloc(static_cast<size_t>(n),
+                                                sizeof(double))
+                    : NULL;
+    if (!A || (hasVertexWeights && !w))
+    {
+        LogError("Error: Ran out of memory in Mongoose::read_graph_metis\n");
+        cs_spfree(A);
+        mongoose_free(w);
+        mongoose_free(buffer);
+        Logger::toc(IOTiming);
+        return NULL;
+    }
+
+    Int *Ap        = A->p;
+    Int nz         = 0;
+    Int selfEdges  = 0;
+    bool ok        = true;
+    for (Int j = 0; j < n && ok; j++)
+    {
+        Ap[j] = nz;
+        s     = nextDataLine(s, false);
+        if (!s)
+        {
+            // Trailing empty lines may have been dropped
+            s = buffer + size;
+        }
+
+        Int size_j;
+        ok = (!hasSizes || parseInt(&s, &size_j))
+             && (!hasVertexWeights || parseDouble(&s, &w[j]));
+
+        Int v;
+        while (ok && parseInt(&s, &v))
+        {
+            double weight = 1;
+            ok = (v >= 1 && v <= n)
+                 && (!hasEdgeWeights || parseDouble(&s, &weight));
+            if (!ok)
+                break;
+            if (v - 1 == j)
+            {
+                selfEdges++;
+                continue;
+            }
+            if (nz == A->nzmax)
+            {
+                int okI = 1, okX = 1;
+                size_t oldSize = static_cast<size_t>(A->nzmax);
+                size_t newSize = 2 * oldSize;
+                A->i = (Int *)mongoose_realloc(newSize, oldSize, sizeof(Int),
+                                               A->i, &okI);
+                if (hasEdgeWeights)
+                {
+                    A->x = (double *)mongoose_realloc(
+                        newSize, oldSize, sizeof(double), A->x, &okX);
+                }
+                ok = okI && okX;
+                if (!ok)
+                    break;
+                A->nzmax = static_cast<Int>(newSize);
+            }
+            A->i[nz] = v - 1;
+            if (hasEdgeWeights)
+                A->x[nz] = weight;
+            nz++;
+        }
+        ok = ok && !skipBlanks(&s);
+    }
+    Ap[n] = nz;
+    mongoose_free(buffer);
+
+    if (!ok)
+    {
+        LogError("Error: Could not parse METIS adjacency lists\n");
+        cs_spfree(A);
+        mongoose_free(w);
+        Logger::toc(IOTiming);
+        return NULL;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* build the graph, sanitizing only if the file is not as declared */
+    /* ---------------------------------------------------------------------- */
+
+    if (nz != 2 * m || selfEdges > 0)
+    {
+        LogWarn("Warning: METIS graph has " << nz << " entries and "
+                                            << selfEdges
+                                            << " self-edges; sanitizing\n");
+        cs *sanitized_A = sanitizeMatrix(A, false, false);
+        cs_spfree(A);
+        A = sanitized_A;
+    }
+
+    Graph *graph = (A) ? Graph::create(A, true) : NULL;
+    if (!graph)
+    {
+        LogError("Error: Ran out of memory in Mongoose::read_graph_metis\n");
+        cs_spfree(A);
+        mongoose_free(w);
+        Logger::toc(IOTiming);
+        return NULL;
+    }
+    graph->w = w;
+
+    A->p = NULL;
+    A->i = NULL;
+    A->x = NULL;
+    cs_spfree(A);
+
+    Logger::toc(IOTiming);
+
+    return graph;
+}
+
+/* ========================================================================== */
+/* === Streaming Matrix Market reader ======================================= */
+/* ========================================================================== */
+
+/* Read the nnz entries of a Matrix Market file, starting at the current
+   position. If Ai is NULL, count the off-diagonal entries of each column of
+   A+A' in p[j+1]. Otherwise, place each entry of A+A' (halved if A is not
+   symmetric) at p[j]++. Returns false if the entries cannot be parsed. */
+bool streamMatrixEntries(FILE *file, Int n, Int nnz, bool pattern,
+                         bool symmetric, Int *p, Int *Ai, double *Ax)
+{
+    const size_t chunkSize = 1 << 20;
+    char *buffer = (char *)mongoose_malloc(chunkSize + 2, sizeof(char));
+    if (!buffer)
+        return false;
+
+    size_t length = 0;
+    bool eof      = false;
+    bool ok       = true;
+    Int k         = 0;
+    while (k < nnz && ok)
+    {
+        if (!eof && length < chunkSize)
+        {
+            size_t count = fread(buffer + length, 1, chunkSize - length, file);
+            eof          = (count == 0);
+            length += count;
+        }
+
+        // Only parse complete lines
+        size_t end = length;
+        while (end > 0 && buffer[end - 1] != '\n')
+            end--;
+        if (end == 0)
+        {
+            if (!eof && length < chunkSize)
+                continue;
+            if (!eof || length == 0)
+            {
+                ok = false; // line too long, or too few entries
+                break;
+            }
+            buffer[length++] = '\n'; // last line has no newline
+            end              = length;
+        }
+        char saved  = buffer[end];
+        buffer[end] = '\0';
+
+        const char *s = buffer;
+        while (*s && k < nnz)
+        {
+            if (!skipBlanks(&s))
+            {
+                s++; // empty line
+                continue;
+            }
+            Int i, j;
+            double x = 1;
+            ok = parseInt(&s, &i) && parseInt(&s, &j)
+                 && (pattern || parseDouble(&s, &x)) && i >= 1 && i <= n
+                 && j >= 1 && j <= n;
+            if (!ok)
+                break;
+            s = strchr(s, '\n') + 1;
+            k++;
+
+            if (i == j)
+                continue;
+            i--;
+            j--;
+            if (!Ai)
+            {
+                p[i + 1]++;
+                p[j + 1]++;
+                continue;
+            }
+            if (!symmetric)
+                x *= 0.5;
+            Ai[p[j]] = i;
+            Ai[p[i]] = j;
+            if (Ax)
+            {
+                Ax[p[j]] = x;
+                Ax[p[i]] = x;
+            }
+            p[j]++;
+            p[i]++;
+        }
+
+        buffer[end] = saved;
+        memmove(buffer, buffer + end, length - end);
+        length -= end;
+    }
+
+    mongoose_free(buffer);
+    return ok;
+}
+
+/* Orders positions in an adjacency list by their row index */
+struct IndexLess
+{
+    const Int *key;
+    IndexLess(const Int *_key) : key(_key) {}
+    bool operator()(Int a, Int b) const { return key[a] < key[b]; }
+};
+
+/* Sort each adjacency list and sum duplicate entries in place, making the
+   edge weights positive. Returns the new number of entries, or -1 if out of
+   memory. */
+Int combineDuplicates(Int n, Int *p, Int *Ai, double *Ax)
+{
+    Int maxDegree = 0;
+    for (Int j = 0; j < n; j++)
+        maxDegree = std::max(maxDegree, p[j + 1] - p[j]);
+
+    Int *perm     = NULL;
+    Int *tempI    = NULL;
+    double *tempX = NULL;
+    if (Ax)
+    {
+        size_t size = static_cast<size_t>(maxDegree);
+        perm        = (Int *)mongoose_malloc(size, sizeof(Int));
+        tempI       = (Int *)mongoose_malloc(size, sizeof(Int));
+        tempX       = (double *)mongoose_malloc(size, sizeof(double));
+        if (!perm || !tempI || !tempX)
+        {
+            mongoose_free(perm);
+            mongoose_free(tempI);
+            mongoose_free(tempX);
+            return -1;
+        }
+    }
+
+    Int nz    = 0;
+    Int start = 0;
+    for (Int j = 0; j < n; j++)
+    {
+        Int end    = p[j + 1];
+        Int degree = end - start;
+        if (Ax)
+        {
+            for (Int k = 0; k < degree; k++)
+            {
+                perm[k]  = k;
+                tempI[k] = Ai[start + k];
+                tempX[k] = Ax[start + k];
+            }
+            std::sort(perm, perm + degree, IndexLess(tempI));
+            for (Int k = 0; k < degree; k++)
+            {
+                Ai[start + k] = tempI[perm[k]];
+                Ax[start + k] = tempX[perm[k]];
+            }
+        }
+        else
+        {
+            std::sort(Ai + start, Ai + end);
+        }
+
+        p[j] = nz;
+        for (Int k = start; k < end; k++)
+        {
+            if (nz > p[j] && Ai[nz - 1] == Ai[k])
+            {
+                if (Ax)
+                    Ax[nz - 1] += Ax[k];
+                continue;
+            }
+            Ai[nz] = Ai[k];
+            if (Ax)
+                Ax[nz] = Ax[k];
+            nz++;
+        }
+        start = end;
+    }
+    p[n] = nz;
+
+    if (Ax)
+    {
+        for (Int k = 0; k < nz; k++)
+            Ax[k] = fabs(Ax[k]);
+    }
+
+    mongoose_free(perm);
+    mongoose_free(tempI);
+    mongoose_free(tempX);
+    return nz;
+}
+
+Graph *read_graph_streaming(const char *filename)
+{
+    Logger::tic(IOTiming);
+    LogInfo("Streaming graph from file " << std::string(filename) << "\n");
+
+    FILE *file = fopen(filename, "r");
+    if (!file)
+    {
+        LogError("Error: Cannot read file " << std::string(filename) << "\n");
+        Logger::toc(IOTiming);
+        return NULL;
+    }
+
+    MM_typecode matcode;
+    long M, N, nnz;
+    if (mm_read_banner(file, &matcode) != 0 || !mm_is_matrix(matcode)
+        || !mm_is_sparse(matcode) || mm_is_complex(matcode)
+        || mm_read_mtx_crd_size(file, &M, &N, &nnz) != 0 || M != N)
+    {
+        LogError("Error: Unsupported or invalid Matrix Market file - must be "
+                 "real, sparse and square\n");
+        fclose(file);
+        Logger::toc(IOTiming);
+        return NULL;
+    }
+    long dataStart = ftell(file);
+
+    Int n          = static_cast<Int>(N);
+    bool pattern   = mm_is_pattern(matcode);
+    bool symmetric = mm_is_symmetric(matcode);
+
+    /* ---------------------------------------------------------------------- */
+    /* pass 1: count the entries of each vertex */
+    /* ---------------------------------------------------------------------- */
+
+    Int *p = (Int *)mongoose_calloc(static_cast<size_t>(n + 1), sizeof(Int));
+    bool ok = p && streamMatrixEntries(file, n, nnz, pattern, symmetric, p,
+                                       NULL, NULL);
+    if (!ok)
+    {
+        LogError("Error: Could not read matrix entries\n");
+        mongoose_free(p);
+        fclose(file);
+        Logger::toc(IOTiming);
+        return NULL;
+    }
+    for (Int j = 0; j < n; j++)
+        p[j + 1] += p[j];
+    Int nz = p[n];
+
+    /* ---------------------------------------------------------------------- */
+    /* pass 2: place the entries, using p[j] as the insertion point */
+    /* ---------------------------------------------------------------------- */
+
+    // A symmetric pattern has no duplicates to weigh, so needs no weights.
+    bool values = !(pattern && symmetric);
+    size_t size = static_cast<size_t>(std::max(nz, (Int)1));
+    Int *Ai     = (Int *)mongoose_malloc(size, sizeof(Int));
+    double *Ax  = (values) ? (double *)mongoose_malloc(size, sizeof(double))
+                           : NULL;
+    ok = Ai && (!values || Ax) && fseek(file, dataStart, SEEK_SET) == 0
+         && streamMatrixEntries(file, n, nnz, pattern, symmetric, p, Ai, Ax);
+    fclose(file);
+
+    if (ok)
+    {
+        // p[j] now points to the end of vertex j
+        for (Int j = n; j > 0; j--)
+            p[j] = p[j - 1];
+        p[0] = 0;
+
+        nz = combineDuplicates(n, p, Ai, Ax);
+        ok = (nz >= 0);
+    }
+
+    Graph *graph = NULL;
+    if (ok)
+    {
+        // Give back the space of the combined duplicates
+        int okI = 1, okX = 1;
+        size_t newSize = static_cast<size_t>(std::max(nz, (Int)1));
+        Ai = (Int *)mongoose_realloc(newSize, size, sizeof(Int), Ai, &okI);
+        if (Ax)
+        {
+            Ax = (double *)mongoose_realloc(newSize, size, sizeof(double),
+                                            Ax, &okX);
+        }
+
+        cs *A = (cs *)mongoose_malloc(1, sizeof(cs));
+        if (A)
+        {
+            A->nzmax = nz;
+            A->m     = n;
+            A->n     = n;
+            A->p     = p;
+            A->i     = Ai;
+            A->x     = Ax;
+            A->nz    = -1;
+            graph    = Graph::create(A, true);
+            mongoose_free(A);
+        }
+    }
+
+    if (!graph)
+    {
+        LogError("Error: Could not read matrix entries or ran out of memory "
+                 "in Mongoose::read_graph_streaming\n");
+        mongoose_free(p);
+        mongoose_free(Ai);
+        mongoose_free(Ax);
+    }
+
+    Logger::toc(IOTiming);
+
+    return graph;
+}
+
+/* Round offset up to the next multiple of BINARY_GRAPH_ALIGN */
+inline uint64_t alignOffset(uint64_t offset)
+{
+    return (offset + BINARY_GRAPH_ALIGN - 1) / BINARY_GRAPH_ALIGN
+           * BINARY_GRAPH_ALIGN;
+}
+
+inline bool writeArray(FILE *file, uint64_t offset, const void *data,
+                       size_t size, size_t count)
+{
+    // Pad with zeros up to the start of the array
+    static const char zeros[BINARY_GRAPH_ALIGN] = { 0 };
+    long position = ftell(file);
+    if (position < 0 || static_cast<uint64_t>(position) > offset)
+        return false;
+    size_t padding = static_cast<size_t>(offset) - static_cast<size_t>(position);
+    if (padding > 0 && fwrite(zeros, 1, padding, file) != padding)
+        return false;
+    return fwrite(data, size, count, file) == count;
+}
+
+bool write_graph_binary(const Graph *graph, const char *filename)
+{
+    return writeBinaryGraph(graph, filename, 0);
+}
+
+bool writeBinaryGraph(const Graph *graph, const char *filename,
+                      uint64_t sourceHash)
+{
+    FILE *file = fopen(filename, "wb");
+    if (!file)
+    {
+        LogError("Error: Cannot write file " << std::string(filename) << "\n");
+        return false;
+    }
+    return writeBinaryGraph(graph, file, filename, sourceHash);
+}
+
+/* Write to a file already open for writing, which is closed, and removed if
+   the graph could not be written */
+bool writeBinaryGraph(const Graph *graph, FILE *file, const char *filename,
+                      uint64_t sourceHash)
+{
+    Logger::tic(IOTiming);
+    LogInfo("Writing binary graph to file " << std::string(filename) << "\n");
+
+    const uint32_t byteOrder = BINARY_GRAPH_BYTE_ORDER;
+    if (*(const unsigned char *)&byteOrder != 0x04)
+    {
+        LogError("Error: Binary graph files require a little-endian host\n");
+        fclose(file);
+        remove(filename);
+        Logger::toc(IOTiming);
+        return false;
+    }
+
+    size_t n  = static_cast<size_t>(graph->n);
+    size_t nz = static_cast<size_t>(graph->nz);
+
+    BinaryGraphHeader header;
+    memset(&header, 0, sizeof(BinaryGraphHeader));
+    memcpy(header.magic, BINARY_GRAPH_MAGIC, sizeof(header.magic));
+    header.version    = BINARY_GRAPH_VERSION;
+    header.byteOrder  = byteOrder;
+    header.intSize    = sizeof(Int);
+    header.doubleSize = sizeof(double);
+    header.n          = graph->n;
+    header.nz         = graph->nz;
+    header.sourceHash = sourceHash;
+
+    uint64_t offset = alignOffset(sizeof(BinaryGraphHeader));
+    header.offsetP  = offset;
+    offset          = alignOffset(offset + (n + 1) * sizeof(Int));
+    header.offsetI  = offset;
+    offset          = offset + nz * sizeof(Int);
+    if (graph->x)
+    {
+        offset         = alignOffset(offset);
+        header.offsetX = offset;
+        offset         = offset + nz * sizeof(double);
+    }
+    if (graph->w)
+    {
+        offset         = alignOffset(offset);
+        header.offsetW = offset;
+        offset         = offset + n * sizeof(double);
+    }
+    header.fileSize = offset;
+
+    bool ok = (fwrite(&header, sizeof(BinaryGraphHeader), 1, file) == 1)
+              && writeArray(file, header.offsetP, graph->p, sizeof(Int), n + 1)
+              && writeArray(file, header.offsetI, graph->i, sizeof(Int), nz)
+              && (!graph->x
+                  || writeArray(file, header.offsetX, graph->x,
+                                sizeof(double), nz))
+              && (!graph->w
+                  || writeArray(file, header.offsetW, graph->w,
+                                sizeof(double), n));
+    ok = (fclose(file) == 0) && ok;
+
+    if (!ok)
+    {
+        LogError("Error: Cannot write file " << std::string(filename) << "\n");
+        remove(filename);
+    }
+
+    Logger::toc(IOTiming);
+    return ok;
+}
+
+bool isBinaryGraphFile(const char *filename)
+{
+    char magic[sizeof(BINARY_GRAPH_MAGIC) - 1];
+    FILE *file = fopen(filename, "rb");
+    if (!file)
+        return false;
+    bool isBinary = (fread(magic, 1, sizeof(magic), file) == sizeof(magic))
+                    && (memcmp(magic, BINARY_GRAPH_MAGIC, sizeof(magic)) == 0);
+    fclose(file);
+    return isBinary;
+}
+
+bool readBinaryGraphSourceHash(const char *filename, uint64_t *sourceHash)
+{
+    BinaryGraphHeader header;
+    FILE *file = fopen(filename, "rb");
+    if (!file)
+        return false;
+    bool ok = (fread(&header, sizeof(BinaryGraphHeader), 1, file) == 1)
+              && (memcmp(header.magic, BINARY_GRAPH_MAGIC,
+                         sizeof(header.magic))
+                  == 0)
+              && header.version == BINARY_GRAPH_VERSION;
+    fclose(file);
+    if (ok)
+        *sourceHash = header.sourceHash;
+    return ok;
+}
+
+/* 64-bit FNV-1a hash of the contents of a file */
+bool hashFile(const char *filename, uint64_t *hash)
+{
+    FILE *file = fopen(filename, "rb");
+    if (!file)
+        return false;
+
+    uint64_t h = 14695981039346656037ULL;
+    unsigned char buffer[1 << 16];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        for (size_t k = 0; k < count; k++)
+        {
+            h ^= buffer[k];
+            h *= 1099511628211ULL;
+        }
+    }
+    bool ok = !ferror(file);
+    fclose(file);
+
+    // 0 is reserved for graphs that were not read through the cache
+    *hash = (h == 0) ? 1 : h;
+    return ok;
+}
+
+/* Create and open a new file named prefix followed by a unique suffix, in
+   the directory of prefix. Returns NULL if it could not be created. Without
+   mkstemp, the suffix is the process id (on Windows) and a counter. */
+FILE *createTempFile(const std::string &prefix, std::string *name)
+{
+#ifdef MONGOOSE_HAVE_MMAP
+    *name  = prefix + ".XXXXXX";
+    int fd = mkstemp(&(*name)[0]);
+    if (fd < 0)
+        return NULL;
+
+    FILE *file = fdopen(fd, "wb");
+    if (!file)
+    {
+        close(fd);
+        remove(name->c_str());
+    }
+    return file;
+#else
+    static std::atomic<unsigned> counter(0);
+    std::ostringstream suffix;
+#ifdef _WIN32
+    suffix << "." << _getpid();
+#endif
+    suffix << "." << counter++;
+    *name = prefix + suffix.str();
+    return fopen(name->c_str(), "wb");
+#endif
+}
+
+Graph *read_graph(const char *filename, bool use_cache)
+{
+    if (!use_cache || isBinaryGraphFile(filename))
+    {
+        return read_graph(filename);
+    }
+
+    uint64_t hash;
+    if (!hashFile(filename, &hash))
+    {
+        return read_graph(filename); // reports the error
+    }
+
+    std::string cacheFile = std::string(filename) + ".mgb";
+    uint64_t cachedHash;
+    if (readBinaryGraphSourceHash(cacheFile.c_str(), &cachedHash)
+        && cachedHash == hash)
+    {
+        LogInfo("Using cached graph " << cacheFile << "\n");
+        Graph *graph = read_graph_binary(cacheFile);
+        if (graph)
+            return graph;
+    }
+
+    Graph *graph = read_graph(filename);
+    if (!graph)
+        return NULL;
+
+    // Write to a temporary file of this process first, so that a partially
+    // written cache is never seen by another process.
+    LogInfo("Caching graph in " << cacheFile << "\n");
+    std::string tempFile;
+    FILE *file = createTempFile(cacheFile, &tempFile);
+    if (!file || !writeBinaryGraph(graph, file, tempFile.c_str(), hash)
+        || rename(tempFile.c_str(), cacheFile.c_str()) != 0)
+    {
+        LogWarn("Warning: Could not write graph cache " << cacheFile << "\n");
+        if (file)
+            remove(tempFile.c_str());
+    }
+
+    return graph;
+}
+
+/* Check that the header describes arrays that lie within the file */
+bool binaryGraphHeaderIsValid(const BinaryGraphHeader *header,
+                              uint64_t fileSize)
+{
+    if (fileSize < sizeof(BinaryGraphHeader)
+        || memcmp(header->magic, BINARY_GRAPH_MAGIC, sizeof(header->magic))
+        || header->version != BINARY_GRAPH_VERSION
+        || header->byteOrder != BINARY_GRAPH_BYTE_ORDER
+        || header->intSize != sizeof(Int)
+        || header->doubleSize != sizeof(double)
+        || header->fileSize != fileSize)
+    {
+        return false;
+    }
+
+    if (header->n < 0 || header->nz < 0
+        || static_cast<uint64_t>(header->n) >= fileSize / sizeof(Int)
+        || static_cast<uint64_t>(header->nz) > fileSize / sizeof(Int))
+    {
+        return false;
+    }
+
+    uint64_t n  = static_cast<uint64_t>(header->n);
+    uint64_t nz = static_cast<uint64_t>(header->nz);
+
+    uint64_t offsets[4] = { header->offsetP, header->offsetI, header->offsetX,
+                            header->offsetW };
+    uint64_t sizes[4]   = { (n + 1) * sizeof(Int), nz * sizeof(Int),
+                          nz * sizeof(double), n * sizeof(double) };
+    for (int k = 0; k < 4; k++)
+    {
+        if (k >= 2 && offsets[k] == 0)
+            continue; // x and w are optional
+        if (offsets[k] < sizeof(BinaryGraphHeader)
+            || offsets[k] % BINARY_GRAPH_ALIGN != 0 || offsets[k] > fileSize
+            || sizes[k] > fileSize - offsets[k])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Check that p is nondecreasing from 0 to nz and that every row index lies
+   in [0, n), in one pass over the arrays */
+bool binaryGraphArraysAreValid(const Int *p, const Int *i, Int n, Int nz)
+{
+    if (p[0] != 0 || p[n] != nz)
+        return false;
+    for (Int k = 0; k < n; k++)
+    {
+        if (p[k] > p[k + 1])
+            return false;
+    }
+    for (Int k = 0; k < nz; k++)
+    {
+        if (i[k] < 0 || i[k] >= n)
+            return false;
+    }
+    return true;
+}
+
+Graph *read_graph_binary(const char *filename)
+{
+    Logger::tic(IOTiming);
+    LogInfo("Reading binary graph from file " << std::string(filename)
+                                              << "\n");
+
+    size_t fileSize = 0;
+    void *data      = NULL;
+
+#ifdef MONGOOSE_HAVE_MMAP
+    int fd = open(filename, O_RDONLY);
+    struct stat fileStat;
+    if (fd < 0 || fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0)
+    {
+        LogError("Error: Cannot read file " << std::string(filename) << "\n");
+        if (fd >= 0)
+            close(fd);
+        Logger::toc(IOTiming);
+        return NULL;
+    }
+    fileSize = static_cast<size_t>(fileStat.st_size);
+
+    // Private mapping: the graph may be modified, but the file never is.
+    data = mmap(NULL, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        LogError("Error: Cannot map file " << std::string(filename) << "\n");
+        Logger::toc(IOTiming);
+        return NULL;
+    }
+#else
+    FILE *file = fopen(filename, "rb");
+    if (!file || fseek(file, 0, SEEK_END) != 0 || ftell(file) <= 0)
+    {
+        LogError("Error: Cannot read file " << std::string(filename) << "\n");
+        if (file)
+            fclose(file);
+        Logger::toc(IOTiming);
+        return NULL;
+    }
+    fileSize = static_cast<size_t>(ftell(file));
+    rewind(file);
+
+    data = mongoose_malloc(fileSize, 1);
+    if (!data || fread(data, 1, fileSize, file) != fileSize)
+    {
+        LogError("Error: Cannot read file " << std::string(filename) << "\n");
+        mongoose_free(data);
+        fclose(file);
+        Logger::toc(IOTiming);
+        return NULL;
+    }
+    fclose(file);
+#endif
+
+    const BinaryGraphHeader *header = (const BinaryGraphHeader *)data;
+    char *base                      = (char *)data;
+
+    bool valid = binaryGraphHeaderIsValid(header, fileSize);
+    Int *p     = (valid) ? (Int *)(base + header->offsetP) : NULL;
+    Int *i     = (valid) ? (Int *)(base + header->offsetI) : NULL;
+    valid      = valid && binaryGraphArraysAreValid(p, i, header->n, header->nz);
+    if (!valid)
+    {
+        LogError("Error: Invalid binary graph file " << std::string(filename)
+                                                     << "\n");
+    }
+
+    Graph *graph = NULL;
+    if (valid)
+    {
+        graph = Graph::create(
+            header->n, header->nz, p, i,
+            (header->offsetX) ? (double *)(base + header->offsetX) : NULL,
+            (header->offsetW) ? (double *)(base + header->offsetW) : NULL);
+        if (!graph)
+        {
+            LogError("Ran out of memory in Mongoose::read_graph_binary\n");
+        }
+    }
+
+    if (!graph)
+    {
+#ifdef MONGOOSE_HAVE_MMAP
+        munmap(data, fileSize);
+#else
+        mongoose_free(data);
+#endif
+        Logger::toc(IOTiming);
+        return NULL;
+    }
+
+    graph->mapping     = data;
+    graph->mappingSize = fileSize;
+
+    Logger::toc(IOTiming);
+
+    return graph;
+}
+
 } // end namespace Mongoose
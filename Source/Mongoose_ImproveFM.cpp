@@ -23,11 +23,11 @@ namespace Mongoose
 //-----------------------------------------------------------------------------
 void improveCutUsingFM(EdgeCutProblem *graph, const EdgeCut_Options *options)
 {
-    Logger::tic(FMTiming);
-
     if (!options->use_FM)
         return;
 
+    Logger::tic(FMTiming, graph->n);
+
     double heuCost = INFINITY;
     for (Int i = 0;
          i < options->FM_max_num_refinements && graph->heuCost < heuCost; i++)
@@ -166,6 +166,9 @@ void fmRefine_worker(EdgeCutProblem *graph, const EdgeCut_Options *options)
         }
     }
 
+    graph->stats.FM_moves += head;
+    graph->stats.FM_moves_undone += tail - head;
+
     /* We've exhausted our search space, so undo all suboptimal moves. */
     for (Int u = tail - 1; u >= head; u--)
     {
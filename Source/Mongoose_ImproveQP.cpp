@@ -27,23 +27,52 @@ bool improveCutUsingQP(EdgeCutProblem *graph, const EdgeCut_Options *options, bo
     if (!options->use_QP_gradproj)
         return false;
 
-    Logger::tic(QPTiming);
+    Logger::tic(QPTiming, graph->n);
 
     /* Unpack structure fields */
-    Int n               = graph->n;
     Int *Gp             = graph->p;
+    Int *Gi             = graph->i;
     double *Gx          = graph->x; // edge weights
     double *Gw          = graph->w; // vertex weights
     double *gains       = graph->vertexGains;
     Int *externalDegree = graph->externalDegree;
+    bool *partition     = graph->partition;
 
-    /* create workspaces */
-    QPDelta *QP = QPDelta::Create(n);
-    if (!QP)
+    /* If requested, restrict the QP to a band of vertices around the cut.
+     * The band vertices are left marked in the graph (see createBandProblem).
+     * If the band spans the whole graph, or we run out of memory, fall back
+     * to solving the QP over the entire graph. */
+    EdgeCutProblem *band = NULL;
+    Int *bandList        = NULL;
+    if (!isInitial && options->QP_band_depth > 0)
     {
-        Logger::toc(QPTiming);
-        return false;
+        // invmatchmap is not needed once a graph has been refined, so reuse
+        // it to hold the band (just as FM reuses matchmap for its stack).
+        bandList = graph->invmatchmap;
+        band     = createBandProblem(graph, options, bandList);
+    }
+    EdgeCutProblem *qpGraph = (band) ? band : graph;
+    Int n                   = qpGraph->n;
+
+    /* Use the workspace shared by all levels if we have one, otherwise
+     * create a temporary one for this call only. */
+    QPDelta *QP = graph->qpWorkspace;
+    bool ownsQP = (QP == NULL);
+    if (ownsQP)
+    {
+        QP = QPDelta::Create(n);
+        if (!QP)
+        {
+            if (band)
+            {
+                graph->clearMarkArray();
+                band->~EdgeCutProblem();
+            }
+            Logger::toc(QPTiming);
+            return false;
+        }
     }
+    ASSERT(n <= QP->numVars);
 
     // set the QP parameters
     double tol         = options->soft_split_tolerance;
@@ -61,25 +90,32 @@ bool improveCutUsingQP(EdgeCutProblem *graph, const EdgeCut_Options *options, bo
     QP->hi = graph->W * std::min(1., targetSplit + tol);
     ASSERT(QP->lo <= QP->hi);
 
-    /* Convert the guess from discrete to continuous. */
-    double *D       = QP->D;
-    double *guess   = QP->x;
-    bool *partition = graph->partition;
-    for (Int k = 0; k < n; k++)
+    /* Convert the guess from discrete to continuous. The free set status
+     * and b = a'x of the guess are computed along the way, so that the
+     * napsack below can be warm started from the lambda of the previous
+     * call (or skipped entirely if the guess is already feasible). */
+    double *D           = QP->D;
+    double *guess       = QP->x;
+    Int *FreeSet_status = QP->FreeSet_status;
+    double b            = 0.0;
+    double bandW1       = 0.0; // weight of the band on side 1
+    for (Int kb = 0; kb < n; kb++)
     {
+        Int k = (band) ? bandList[kb] : kb;
         if (isInitial)
         {
-            guess[k] = targetSplit;
+            guess[kb] = targetSplit;
         }
         else
         {
             if (partition[k])
             {
-                guess[k] = graph->BH_inBoundary(k) ? 0.75 : 1.0;
+                guess[kb] = graph->BH_inBoundary(k) ? 0.75 : 1.0;
+                bandW1 += (Gw) ? Gw[k] : 1;
             }
             else
             {
-                guess[k] = graph->BH_inBoundary(k) ? 0.25 : 0.0;
+                guess[kb] = graph->BH_inBoundary(k) ? 0.25 : 0.0;
             }
         }
         double maxWeight = 0;
@@ -87,22 +123,78 @@ bool improveCutUsingQP(EdgeCutProblem *graph, const EdgeCut_Options *options, bo
         {
             maxWeight = std::max(maxWeight, (Gx) ? Gx[p] : 1);
         }
-        D[k] = maxWeight;
+        D[kb] = maxWeight;
+
+        FreeSet_status[kb] = (guess[kb] >= 1.0) ? 1 : (guess[kb] <= 0.0) ? -1 : 0;
+        b += ((Gw) ? Gw[k] : 1) * guess[kb];
+    }
+    QP->b = b;
+
+    if (band)
+    {
+        // Vertices outside the band stay where they are, so the balance
+        // constraint on the band is shifted by the weight fixed on side 1.
+        double fixedW1 = graph->W1 - bandW1;
+        QP->lo = std::min(std::max(QP->lo - fixedW1, 0.), band->W);
+        QP->hi = std::min(std::max(QP->hi - fixedW1, 0.), band->W);
     }
 
     // lo <= a'x <= hi might not hold here
 
-    QP->lambda = 0;
     if (QP->b < QP->lo || QP->b > QP->hi)
     {
-        QP->lambda = QPNapsack(guess, n, QP->lo, QP->hi, graph->w, QP->lambda,
-                               QP->FreeSet_status, QP->wx[1], QP->wi[0],
-                               QP->wi[1], options->gradproj_tolerance);
+        QP->lambda = QPNapsack(guess, n, QP->lo, QP->hi, qpGraph->w,
+                               QP->lambda, QP->FreeSet_status, QP->wx[1],
+                               QP->wi[0], QP->wi[1],
+                               options->gradproj_tolerance,
+                               options->napsack_solver);
     }
 
     // Build the FreeSet, compute grad, possibly adjust QP->lo and QP->hi
-    if (!QPLinks(graph, options, QP))
+    bool linked = QPLinks(qpGraph, options, QP);
+
+    if (band)
+    {
+        // Add the (constant) contribution of the fixed neighbors of each band
+        // vertex to the gradient. The band vertices are still marked.
+        double *grad = QP->gradient;
+#ifndef NDEBUG
+        // for debugging only; the gradient checks include it
+        QP->gradientOffset = (double *)mongoose_malloc(n + 1, sizeof(double));
+#endif
+        for (Int kb = 0; kb < n; kb++)
+        {
+            Int k         = bandList[kb];
+            double offset = 0.;
+            for (Int p = Gp[k]; p < Gp[k + 1]; p++)
+            {
+                Int j = Gi[p];
+                if (!graph->isMarked(j))
+                {
+                    offset += (partition[j] ? -0.5 : 0.5) * ((Gx) ? Gx[p] : 1);
+                }
+            }
+            grad[kb] += offset;
+            DEBUG(QP->gradientOffset[kb] = offset);
+        }
+
+        // fmSwap below relies on the graph's marks being clear
+        graph->clearMarkArray();
+    }
+
+    if (!linked)
     {
+#ifndef NDEBUG
+        mongoose_free(QP->gradientOffset);
+        QP->gradientOffset = NULL;
+#endif
+        if (band)
+            band->~EdgeCutProblem();
+        if (ownsQP)
+        {
+            QP->~QPDelta();
+            mongoose_free(QP);
+        }
         Logger::toc(QPTiming);
         return false;
     }
@@ -110,10 +202,18 @@ bool improveCutUsingQP(EdgeCutProblem *graph, const EdgeCut_Options *options, bo
     // lo <= a'x <= hi now holds (lo and hi are modified as needed in QPLinks)
 
     /* Do one run of gradient projection. */
-    QPGradProj(graph, options, QP);
-    QPBoundary(graph, options, QP);
-    QPGradProj(graph, options, QP);
-    QPBoundary(graph, options, QP);
+    QPGradProj(qpGraph, options, QP);
+    graph->gradprojIterations += QP->its;
+    graph->stats.QP_iterations += QP->its;
+    QPBoundary(qpGraph, options, QP);
+    graph->stats.QP_residual = QPGradProj(qpGraph, options, QP);
+    graph->gradprojIterations += QP->its;
+    graph->stats.QP_iterations += QP->its;
+    QPBoundary(qpGraph, options, QP);
+#ifndef NDEBUG
+    mongoose_free(QP->gradientOffset);
+    QP->gradientOffset = NULL;
+#endif
 
     /* Use the CutCost to keep track of impacts to the cut cost. */
     CutCost cost;
@@ -123,9 +223,10 @@ bool improveCutUsingQP(EdgeCutProblem *graph, const EdgeCut_Options *options, bo
     cost.imbalance = graph->imbalance;
 
     /* Do the recommended swaps and compute the new cut cost. */
-    for (Int k = 0; k < n; k++)
+    for (Int kb = 0; kb < n; kb++)
     {
-        bool newPartition = (guess[k] > 0.5);
+        Int k             = (band) ? bandList[kb] : kb;
+        bool newPartition = (guess[kb] > 0.5);
         bool oldPartition = partition[k];
 
         if (newPartition != oldPartition)
@@ -160,9 +261,16 @@ bool improveCutUsingQP(EdgeCutProblem *graph, const EdgeCut_Options *options, bo
     // clear the marks from all the vertices
     graph->clearMarkArray();
 
-    /* Free the QP structure */
-    QP->~QPDelta();
-    SuiteSparse_free(QP);
+    /* Free the band and the QP structure (unless it is shared across levels) */
+    if (band)
+    {
+        band->~EdgeCutProblem();
+    }
+    if (ownsQP)
+    {
+        QP->~QPDelta();
+        mongoose_free(QP);
+    }
 
     /* Write the cut cost back to the graph. */
     graph->cutCost      = cost.cutCost;
@@ -180,4 +288,127 @@ bool improveCutUsingQP(EdgeCutProblem *graph, const EdgeCut_Options *options, bo
     return true;
 }
 
+EdgeCutProblem *createBandProblem(EdgeCutProblem *graph,
+                                  const EdgeCut_Options *options,
+                                  Int *bandList)
+{
+    Int n      = graph->n;
+    Int *Gp    = graph->p;
+    Int *Gi    = graph->i;
+    double *Gx = graph->x;
+    double *Gw = graph->w;
+
+    /* Breadth-first search outward from the boundary, marking the band. */
+    graph->clearMarkArray();
+    Int nb = 0;
+    for (Int h = 0; h < 2; h++)
+    {
+        for (Int b = 0; b < graph->bhSize[h]; b++)
+        {
+            Int k = graph->bhHeap[h][b];
+            graph->mark(k);
+            bandList[nb++] = k;
+        }
+    }
+
+    Int head = 0;
+    for (Int depth = 0; depth < options->QP_band_depth && nb < n; depth++)
+    {
+        Int tail = nb;
+        for (; head < tail; head++)
+        {
+            Int k = bandList[head];
+            for (Int p = Gp[k]; p < Gp[k + 1]; p++)
+            {
+                Int j = Gi[p];
+                if (!graph->isMarked(j))
+                {
+                    graph->mark(j);
+                    bandList[nb++] = j;
+                }
+            }
+        }
+    }
+
+    /* Nothing to gain from a band that is empty or covers the entire graph. */
+    if (nb == 0 || nb == n)
+    {
+        graph->clearMarkArray();
+        return NULL;
+    }
+
+    /* Count the edges that have both endpoints in the band. */
+    Int nz = 0;
+    for (Int kb = 0; kb < nb; kb++)
+    {
+        Int k = bandList[kb];
+        for (Int p = Gp[k]; p < Gp[k + 1]; p++)
+        {
+            nz += graph->isMarked(Gi[p]);
+        }
+    }
+
+    EdgeCutProblem *band = EdgeCutProblem::create(nb, nz);
+    if (band && !band->allocateMarkArray())
+    {
+        band->~EdgeCutProblem();
+        band = NULL;
+    }
+    if (!band)
+    {
+        graph->clearMarkArray();
+        return NULL;
+    }
+
+    band->x = (Gx) ? (double *)mongoose_malloc(nz, sizeof(double)) : NULL;
+    band->w = (Gw) ? (double *)mongoose_malloc(nb, sizeof(double)) : NULL;
+    if ((Gx && !band->x) || (Gw && !band->w))
+    {
+        graph->clearMarkArray();
+        band->~EdgeCutProblem();
+        return NULL;
+    }
+
+    Int *Bp    = band->p;
+    Int *Bi    = band->i;
+    double *Bx = band->x;
+    double *Bw = band->w;
+
+    /* The band has its own numbering. Map each band vertex to its position
+     * in bandList, using the graph's matchmap (which, like invmatchmap, is
+     * no longer needed at this point). */
+    Int *map = graph->matchmap;
+    for (Int kb = 0; kb < nb; kb++)
+    {
+        map[bandList[kb]] = kb;
+    }
+
+    nz = 0;
+    for (Int kb = 0; kb < nb; kb++)
+    {
+        Int k  = bandList[kb];
+        Bp[kb] = nz;
+        for (Int p = Gp[k]; p < Gp[k + 1]; p++)
+        {
+            Int j = Gi[p];
+            if (graph->isMarked(j))
+            {
+                Bi[nz] = map[j];
+                if (Bx)
+                    Bx[nz] = Gx[p];
+                nz++;
+            }
+        }
+        double wk = (Gw) ? Gw[k] : 1;
+        if (Bw)
+            Bw[kb] = wk;
+        band->W += wk;
+    }
+    Bp[nb] = nz;
+
+    band->worstCaseRatio = graph->worstCaseRatio;
+
+    return band;
+}
+
 } // end namespace Mongoose
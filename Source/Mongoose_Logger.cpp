@@ -16,11 +16,15 @@
  * allows this information to be displayed (or not) without recompilation.
  * Timing inforation for different *portions of the library are also managed
  * here with a tic/toc pattern.
+ *
+ * Times are measured on a monotonic wall clock and kept separately for each
+ * thread, both in total and per coarsening level.
  */
 
 #include "Mongoose_Logger.hpp"
 #include "Mongoose_Debug.hpp"
 #include "Mongoose_Internal.hpp"
+#include <algorithm>
 #include <iomanip>
 
 namespace Mongoose
@@ -28,8 +32,17 @@ namespace Mongoose
 
 int Logger::debugLevel = None;
 bool Logger::timingOn  = false;
-clock_t Logger::clocks[6];
-float Logger::times[6];
+thread_local double Logger::starts[NumTimingTypes];
+thread_local double Logger::times[NumTimingTypes];
+thread_local double Logger::levelTimes[MaxTimingLevels][NumTimingTypes];
+thread_local int Logger::level     = 0;
+thread_local int Logger::numLevels = 1;
+
+/* Names of the timed phases, as they appear in a trace */
+const char *const Logger::timingNames[NumTimingTypes]
+    = { "match",          "coarsen",           "refine",
+        "improveCutUsingFM", "improveCutUsingQP", "IO",
+        "sanitizeMatrix",    "guessCut" };
 
 void Logger::setDebugLevel(int debugType)
 {
@@ -41,20 +54,201 @@ void Logger::setTimingFlag(bool tFlag)
     timingOn = tFlag;
 }
 
+/**
+ * Set the coarsening level the following timings are charged to.
+ *
+ * Level 0 is the input graph. Levels at or beyond MaxTimingLevels are
+ * all charged to the last level.
+ */
+void Logger::setTimingLevel(Int timingLevel)
+{
+    level = static_cast<int>(
+        std::min(std::max(timingLevel, (Int)0), (Int)MaxTimingLevels - 1));
+    numLevels = std::max(numLevels, level + 1);
+}
+
+/**
+ * Get the time recorded for a given timing type at a given coarsening level.
+ *
+ * @param timingType The portion of the library being timed.
+ * @param timingLevel The coarsening level, between 0 and getTimingLevels()-1.
+ */
+double Logger::getTime(TimingType timingType, Int timingLevel)
+{
+    if (timingLevel < 0 || timingLevel >= numLevels)
+        return 0;
+    return levelTimes[timingLevel][timingType];
+}
+
+/* The number of coarsening levels with recorded timings on this thread */
+Int Logger::getTimingLevels()
+{
+    return numLevels;
+}
+
+/* Clear the timings of this thread */
+void Logger::resetTiming()
+{
+    for (int t = 0; t < NumTimingTypes; t++)
+    {
+        times[t] = 0;
+        for (int l = 0; l < MaxTimingLevels; l++)
+            levelTimes[l][t] = 0;
+    }
+    level     = 0;
+    numLevels = 1;
+    PerfCounters::reset();
+    MemoryAccounting::reset();
+}
+
 void Logger::printTimingInfo()
 {
-    std::cout << " Matching:   " << std::setprecision(4)
-              << times[MatchingTiming] << "s\n";
-    std::cout << " Coarsening: " << std::setprecision(4)
-              << times[CoarseningTiming] << "s\n";
-    std::cout << " Refinement: " << std::setprecision(4)
-              << times[RefinementTiming] << "s\n";
-    std::cout << " FM:         " << std::setprecision(4) << times[FMTiming]
-              << "s\n";
-    std::cout << " QP:         " << std::setprecision(4) << times[QPTiming]
-              << "s\n";
-    std::cout << " IO:         " << std::setprecision(4) << times[IOTiming]
-              << "s\n";
+    static const char *names[NumTimingTypes]
+        = { "Matching:  ", "Coarsening:", "Refinement:", "FM:        ",
+            "QP:        ", "IO:        ", "Sanitize:  ", "Guess Cut: " };
+
+    // Leave the caller's formatting of std::cout as it was
+    std::ios_base::fmtflags flags = std::cout.flags();
+    std::streamsize precision     = std::cout.precision();
+
+    for (int t = 0; t < NumTimingTypes; t++)
+    {
+        std::cout << " " << names[t] << " " << std::setprecision(4)
+                  << times[t] << "s\n";
+    }
+
+    if (numLevels > 1)
+    {
+        std::cout << " Level   Matching Coarsening Refinement         FM"
+                     "         QP  Guess Cut\n";
+        for (int l = 0; l < numLevels; l++)
+        {
+            std::cout << " " << std::setw(5) << l;
+            for (int t = 0; t < NumTimingTypes; t++)
+            {
+                if (t == IOTiming || t == SanitizeTiming)
+                    continue;
+                std::cout << " " << std::setw(10) << std::setprecision(4)
+                          << levelTimes[l][t];
+            }
+            std::cout << "\n";
+        }
+    }
+    bool anyCounter = false;
+    for (int c = 0; c < PerfCounters::NumCounters; c++)
+        anyCounter = anyCounter || PerfCounters::isAvailable((PerfCounterType)c);
+    if (PerfCounters::isOn() && anyCounter)
+    {
+        std::cout << " Phase           Cycles   Instructions    IPC"
+                     "     LLC misses  Branch misses    dTLB misses\n";
+        for (int t = 0; t < NumTimingTypes; t++)
+        {
+            double cycles       = PerfCounters::get(t, CyclesCounter);
+            double instructions = PerfCounters::get(t, InstructionsCounter);
+            std::cout << " " << names[t] << std::fixed << std::setprecision(0)
+                      << std::setw(15) << cycles << std::setw(15)
+                      << instructions << std::setw(7) << std::setprecision(2)
+                      << ((cycles > 0 && instructions >= 0)
+                              ? instructions / cycles
+                              : -1)
+                      << std::setprecision(0) << std::setw(15)
+                      << PerfCounters::get(t, LLCMissesCounter) << std::setw(15)
+                      << PerfCounters::get(t, BranchMissesCounter)
+                      << std::setw(15) << PerfCounters::get(t, DTLBMissesCounter)
+                      << "\n";
+        }
+    }
+    if (MemoryAccounting::isOn())
+    {
+        std::cout << " Phase        Peak bytes  Allocated bytes\n";
+        for (int t = 0; t < NumTimingTypes; t++)
+        {
+            std::cout << " " << names[t] << std::setw(15)
+                      << MemoryAccounting::peak(t) << std::setw(17)
+                      << MemoryAccounting::allocated(t) << "\n";
+        }
+        std::cout << " Peak:      " << std::setw(15) << MemoryAccounting::peak()
+                  << "\n";
+    }
+
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
+
+bool set_perf_counters(bool enabled)
+{
+    return PerfCounters::setCountersFlag(enabled);
+}
+
+double get_perf_counter(TimingType timingType, PerfCounterType counter)
+{
+    return PerfCounters::get(timingType, counter);
+}
+
+double get_perf_counter(TimingType timingType, PerfCounterType counter,
+                        Int level)
+{
+    return PerfCounters::get(timingType, counter, level);
+}
+
+void set_memory_accounting(bool enabled)
+{
+    MemoryAccounting::setAccountingFlag(enabled);
+}
+
+Int get_memory_in_use()
+{
+    return MemoryAccounting::inUse();
+}
+
+Int get_memory_peak()
+{
+    return MemoryAccounting::peak();
+}
+
+Int get_memory_peak(TimingType timingType)
+{
+    return MemoryAccounting::peak(timingType);
+}
+
+Int get_memory_peak(TimingType timingType, Int level)
+{
+    return MemoryAccounting::peak(timingType, level);
+}
+
+Int get_memory_allocated(TimingType timingType)
+{
+    return MemoryAccounting::allocated(timingType);
+}
+
+Int get_memory_allocated(TimingType timingType, Int level)
+{
+    return MemoryAccounting::allocated(timingType, level);
+}
+
+void set_timing(bool enabled)
+{
+    Logger::setTimingFlag(enabled);
+}
+
+void reset_timing()
+{
+    Logger::resetTiming();
+}
+
+double get_timing(TimingType timingType)
+{
+    return Logger::getTime(timingType);
+}
+
+double get_timing(TimingType timingType, Int level)
+{
+    return Logger::getTime(timingType, level);
+}
+
+Int get_timing_levels()
+{
+    return Logger::getTimingLevels();
 }
 
 } // end namespace Mongoose
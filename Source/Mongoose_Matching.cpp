@@ -14,8 +14,10 @@
  *
  * During coarsening, a matching of vertices is computed to determine
  * which vertices are combined together into supervertices. This can be done
- * using a number of different strategies, including Heavy Edge Matching and
- * Community/Brotherly (similar to 2-hop) Matching.
+ * using a number of different strategies, including Heavy Edge Matching,
+ * Community/Brotherly (similar to 2-hop) Matching, and clustering by label
+ * propagation. The vertices combined into one supervertex are linked into a
+ * cycle by graph->matching, so a supervertex may have any number of them.
  */
 
 #include "Mongoose_Matching.hpp"
@@ -23,15 +25,29 @@
 #include "Mongoose_Internal.hpp"
 #include "Mongoose_Logger.hpp"
 
+#include <algorithm>
+
 namespace Mongoose
 {
 
+/* The heaviest a cluster may become in label propagation or two-hop
+ * matching: eight times the average vertex weight, so that a level shrinks
+ * the graph by at most about 8x and the coarse graphs still resemble the
+ * fine one, but no more than the average weight of a vertex of a coarsest
+ * graph of coarsen_limit vertices. */
+inline double maxClusterWeight(EdgeCutProblem *graph,
+                               const EdgeCut_Options *options)
+{
+    return std::min(8 * graph->W / static_cast<double>(graph->n),
+                    graph->W / static_cast<double>(options->coarsen_limit));
+}
+
 //-----------------------------------------------------------------------------
 // top-level matching code that serves as a multiple-dispatch system.
 //-----------------------------------------------------------------------------
 void match(EdgeCutProblem *graph, const EdgeCut_Options *options)
 {
-    Logger::tic(MatchingTiming);
+    Logger::tic(MatchingTiming, graph->n);
     switch (options->matching_strategy)
     {
     case Random:
@@ -51,6 +67,27 @@ void match(EdgeCutProblem *graph, const EdgeCut_Options *options)
         matching_HEM(graph, options);
         matching_SRdeg(graph, options);
         break;
+
+    case LabelProp:
+        matching_LabelProp(graph, options);
+        matching_HEM(graph, options);
+        matching_SR(graph, options);
+        break;
+    }
+
+    /* If the vertices left unmatched would keep the coarse graph from
+     * shrinking by coarsen_min_shrink, cluster them around their neighbors. */
+    if (options->coarsen_min_shrink > 0)
+    {
+        Int n         = graph->n;
+        Int unmatched = 0;
+        for (Int k = 0; k < n; k++)
+            unmatched += !graph->isMatched(k);
+        if (static_cast<double>(graph->cn + unmatched)
+            > (1 - options->coarsen_min_shrink) * static_cast<double>(n))
+        {
+            matching_TwoHop(graph, options);
+        }
     }
     matching_Cleanup(graph, options);
     Logger::toc(MatchingTiming);
@@ -127,7 +164,8 @@ void matching_Cleanup(EdgeCutProblem *graph, const EdgeCut_Options *options)
     }
 
 #ifndef NDEBUG
-    /* Every vertex must be matched in no more than a 3-way matching. */
+    /* Every vertex must be in a cycle of vertices of the same supervertex:
+     * itself alone, a 2- or 3-way matching, or a cluster. */
     for (Int k = 0; k < n; k++)
     {
         if (options->do_community_matching)
@@ -137,45 +175,15 @@ void matching_Cleanup(EdgeCutProblem *graph, const EdgeCut_Options *options)
             ASSERT(graph->isMatched(k));
         }
 
-        /* Load matching. */
-        Int v[3] = { -1, -1, -1 };
-        v[0]     = k;
-        v[1]     = graph->getMatch(v[0]);
-
-        if (v[1] == v[0])
+        Int v      = k;
+        Int length = 0;
+        do
         {
-            v[1] = -1;
-        }
-
-        if (v[1] != -1)
-        {
-            v[2] = graph->getMatch(v[1]);
-            if (v[2] == v[0])
-                v[2] = -1;
-        }
-
-        if (options->do_community_matching)
-        {
-            if (v[2] != -1)
-            {
-                ASSERT(graph->getMatch(v[2]) == v[0]);
-            }
-            else
-            {
-                ASSERT(graph->getMatch(v[1]) == v[0]);
-            }
-        }
-        else
-        {
-            if (v[1] != -1)
-            {
-                ASSERT(graph->getMatch(v[1]) == v[0]);
-            }
-            else
-            {
-                ASSERT(graph->getMatch(v[0]) == v[0]);
-            }
-        }
+            ASSERT(graph->matchmap[v] == graph->matchmap[k]);
+            v = graph->getMatch(v);
+            length++;
+        } while (v != k && length <= n);
+        ASSERT(v == k);
     }
 #endif
 }
@@ -454,4 +462,205 @@ void matching_HEM(EdgeCutProblem *graph, const EdgeCut_Options *options)
 #endif
 }
 
+//-----------------------------------------------------------------------------
+// Clusters of any size found by size-constrained label propagation
+//-----------------------------------------------------------------------------
+void matching_LabelProp(EdgeCutProblem *graph, const EdgeCut_Options *options)
+{
+    Int n      = graph->n;
+    Int *Gp    = graph->p;
+    Int *Gi    = graph->i;
+    double *Gx = graph->x;
+    double *Gw = graph->w;
+
+    /* Each vertex starts in a cluster of its own, labelled by the vertex.
+     * In each round, every vertex in turn joins the neighboring cluster it
+     * is most strongly connected to, unless that would make the cluster
+     * heavier than maxClusterWeight. Vertices left alone are not matched
+     * here, so that heavy edge and stall-reducing matching can pair them. */
+    const Int rounds = 3;
+
+    size_t size           = static_cast<size_t>(n);
+    Int *label            = (Int *)mongoose_malloc(size, sizeof(Int));
+    Int *touched          = (Int *)mongoose_malloc(size, sizeof(Int));
+    Int *last             = (Int *)mongoose_malloc(size, sizeof(Int));
+    double *clusterWeight = (double *)mongoose_malloc(size, sizeof(double));
+    double *connection    = (double *)mongoose_calloc(size, sizeof(double));
+    if (!label || !touched || !last || !clusterWeight || !connection)
+    {
+        /* Out of memory: leave everything to the matching that follows */
+        mongoose_free(label);
+        mongoose_free(touched);
+        mongoose_free(last);
+        mongoose_free(clusterWeight);
+        mongoose_free(connection);
+        return;
+    }
+
+    double maxWeight = maxClusterWeight(graph, options);
+    for (Int k = 0; k < n; k++)
+    {
+        label[k]         = k;
+        clusterWeight[k] = (Gw) ? Gw[k] : 1;
+    }
+
+    for (Int round = 0; round < rounds; round++)
+    {
+        Int moves = 0;
+        for (Int k = 0; k < n; k++)
+        {
+            /* Sum the weight of the edges from k to each neighboring cluster */
+            Int numTouched = 0;
+            for (Int p = Gp[k]; p < Gp[k + 1]; p++)
+            {
+                Int c = label[Gi[p]];
+                if (connection[c] == 0)
+                    touched[numTouched++] = c;
+                connection[c] += (Gx) ? Gx[p] : 1;
+            }
+
+            Int current     = label[k];
+            double weight   = (Gw) ? Gw[k] : 1;
+            Int best        = current;
+            double bestConn = connection[current];
+            for (Int t = 0; t < numTouched; t++)
+            {
+                Int c = touched[t];
+                if (connection[c] > bestConn
+                    && clusterWeight[c] + weight <= maxWeight)
+                {
+                    best     = c;
+                    bestConn = connection[c];
+                }
+                connection[c] = 0;
+            }
+
+            if (best != current)
+            {
+                clusterWeight[current] -= weight;
+                clusterWeight[best] += weight;
+                label[k] = best;
+                moves++;
+            }
+        }
+        if (moves == 0)
+            break;
+    }
+
+    /* Link the vertices of each cluster of two or more into a cycle, in
+     * order, reusing touched as the first vertex of each cluster. */
+    Int *first = touched;
+    for (Int c = 0; c < n; c++)
+        first[c] = -1;
+    for (Int k = 0; k < n; k++)
+    {
+        Int c = label[k];
+        if (first[c] < 0)
+        {
+            first[c] = k;
+        }
+        else
+        {
+            if (last[c] == first[c])
+            {
+                /* A second vertex: the cluster becomes a supervertex */
+                graph->invmatchmap[graph->cn] = first[c];
+                graph->matchmap[first[c]]     = graph->cn;
+                graph->matchtype[first[c]]    = MatchType_Standard;
+                graph->cn++;
+            }
+            graph->matching[last[c]] = k + 1;
+            graph->matchmap[k]       = graph->matchmap[first[c]];
+            graph->matchtype[k]      = MatchType_Standard;
+        }
+        last[c] = k;
+    }
+    for (Int c = 0; c < n; c++)
+    {
+        if (first[c] >= 0 && last[c] != first[c])
+            graph->matching[last[c]] = first[c] + 1;
+    }
+
+    mongoose_free(label);
+    mongoose_free(touched);
+    mongoose_free(last);
+    mongoose_free(clusterWeight);
+    mongoose_free(connection);
+}
+
+/* Add the unmatched vertex v to the cluster of k, linking it into the cycle
+ * after k, unless the cluster (of weight *weight) would then be heavier than
+ * maxWeight. Returns true if v was added. */
+inline bool joinCluster(EdgeCutProblem *graph, Int k, Int v, double maxWeight,
+                        double *weight)
+{
+    double vWeight = (graph->w) ? graph->w[v] : 1;
+    if (*weight + vWeight > maxWeight)
+        return false;
+    *weight += vWeight;
+
+    if (!graph->isMatched(k))
+    {
+        graph->createMatch(k, v, MatchType_Brotherly);
+    }
+    else
+    {
+        graph->matching[v]  = graph->matching[k];
+        graph->matching[k]  = v + 1;
+        graph->matchmap[v]  = graph->matchmap[k];
+        graph->matchtype[v] = MatchType_Brotherly;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Clusters the unmatched vertices that share a neighbor, used when matching
+// stalls (e.g. on the leaves of a star, which can only be matched in pairs)
+//-----------------------------------------------------------------------------
+void matching_TwoHop(EdgeCutProblem *graph, const EdgeCut_Options *options)
+{
+    Int n      = graph->n;
+    Int *Gp    = graph->p;
+    Int *Gi    = graph->i;
+    double *Gx = graph->x;
+    double *Gw = graph->w;
+
+    double maxWeight = maxClusterWeight(graph, options);
+
+    for (Int k = 0; k < n; k++)
+    {
+        /* Consider only unmatched vertices */
+        if (graph->isMatched(k))
+            continue;
+
+        Int heaviestNeighbor  = -1;
+        double heaviestWeight = -1.0;
+        for (Int p = Gp[k]; p < Gp[k + 1]; p++)
+        {
+            double x = (Gx) ? Gx[p] : 1;
+            if (x > heaviestWeight)
+            {
+                heaviestWeight   = x;
+                heaviestNeighbor = Gi[p];
+            }
+        }
+        if (heaviestNeighbor == -1)
+            continue;
+
+        /* Gather the heaviest neighbor, if unmatched, and its unmatched
+         * neighbors into k's cluster */
+        double weight = (Gw) ? Gw[k] : 1;
+        if (!graph->isMatched(heaviestNeighbor))
+            joinCluster(graph, k, heaviestNeighbor, maxWeight, &weight);
+        for (Int p = Gp[heaviestNeighbor]; p < Gp[heaviestNeighbor + 1]; p++)
+        {
+            Int v = Gi[p];
+            if (v == k || graph->isMatched(v))
+                continue;
+            if (!joinCluster(graph, k, v, maxWeight, &weight))
+                break;
+        }
+    }
+}
+
 } // end namespace Mongoose
@@ -0,0 +1,292 @@
+/* ========================================================================== */
+/* === Source/Mongoose_MemoryAccounting.cpp ================================= */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+#include "Mongoose_MemoryAccounting.hpp"
+#include "Mongoose_Logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace Mongoose
+{
+
+thread_local bool MemoryAccounting::accountingOn = false;
+
+static const int NumTimingTypes = Logger::NumTimingTypes;
+static const int MaxLevels      = Logger::MaxTimingLevels;
+
+/* The accounting of one thread */
+struct MemoryState
+{
+    Int session;                          /* accounting session, 0 if off */
+    Int inUse;                            /* bytes in the blocks counted  */
+    Int peak;                             /* most bytes in use since reset */
+    bool running[NumTimingTypes];         /* timing types between tic/toc */
+    Int peaks[MaxLevels][NumTimingTypes]; /* peak while each type ran     */
+    Int allocated[MaxLevels][NumTimingTypes]; /* bytes allocated by each  */
+
+    MemoryState() : session(0), inUse(0), peak(0)
+    {
+        for (int t = 0; t < NumTimingTypes; t++)
+            running[t] = false;
+        clear();
+    }
+
+    void clear()
+    {
+        for (int l = 0; l < MaxLevels; l++)
+        {
+            for (int t = 0; t < NumTimingTypes; t++)
+            {
+                peaks[l][t]     = 0;
+                allocated[l][t] = 0;
+            }
+        }
+    }
+
+    /* Raise the peaks of the running timing types to the bytes in use */
+    void update(Int bytes)
+    {
+        peak  = std::max(peak, inUse);
+        int l = static_cast<int>(Logger::getTimingLevel());
+        for (int t = 0; t < NumTimingTypes; t++)
+        {
+            if (running[t])
+            {
+                peaks[l][t] = std::max(peaks[l][t], inUse);
+                allocated[l][t] += bytes;
+            }
+        }
+    }
+};
+
+static thread_local MemoryState state;
+
+/* Sessions are numbered across all threads, so that a block counted by one
+   thread or session is not taken off the bytes in use of another */
+static std::atomic<Int> lastSession(0);
+
+/* === Allocation functions ================================================= */
+
+/* Each block allocated by Mongoose starts with a header holding its size and
+   the accounting session it was counted in (0 if none). The header keeps the
+   alignment of the memory returned by SuiteSparse_malloc. */
+struct alignas(std::max_align_t) BlockHeader
+{
+    Int size;
+    Int session;
+};
+
+/* The size of nitems items of size_of_item bytes (at least 1 each, as in
+   SuiteSparse_malloc), or 0 if a block of that size plus its header would
+   overflow size_t */
+static size_t blockSize(size_t nitems, size_t size_of_item)
+{
+    nitems       = std::max<size_t>(nitems, 1);
+    size_of_item = std::max<size_t>(size_of_item, 1);
+    if (nitems > (SIZE_MAX - sizeof(BlockHeader)) / size_of_item)
+        return 0;
+    return nitems * size_of_item;
+}
+
+/* Fill in the header of a block of size bytes, count it if accounting is
+   on, and return the memory after the header */
+static void *countBlock(void *block, size_t size)
+{
+    if (!block)
+        return NULL;
+
+    BlockHeader *header = static_cast<BlockHeader *>(block);
+    header->size        = static_cast<Int>(size);
+    header->session     = state.session;
+    if (header->session)
+    {
+        state.inUse += header->size;
+        state.update(header->size);
+    }
+    return header + 1;
+}
+
+/* Take a block off the bytes in use, if it was counted in this session */
+static void uncountBlock(const BlockHeader *header)
+{
+    if (header->session && header->session == state.session)
+        state.inUse -= header->size;
+}
+
+void *mongoose_malloc(size_t nitems, size_t size_of_item)
+{
+    size_t size = blockSize(nitems, size_of_item);
+    if (size == 0)
+        return NULL;
+    return countBlock(SuiteSparse_malloc(1, sizeof(BlockHeader) + size), size);
+}
+
+void *mongoose_calloc(size_t nitems, size_t size_of_item)
+{
+    size_t size = blockSize(nitems, size_of_item);
+    if (size == 0)
+        return NULL;
+    return countBlock(SuiteSparse_calloc(1, sizeof(BlockHeader) + size), size);
+}
+
+/* As SuiteSparse_realloc: on failure, ok is 0 and p is returned unchanged.
+   The old size is taken from the header of p; nitems_old is not used. */
+void *mongoose_realloc(size_t nitems_new, size_t nitems_old,
+                       size_t size_of_item, void *p, int *ok)
+{
+    (void)nitems_old;
+    if (!p)
+    {
+        p     = mongoose_malloc(nitems_new, size_of_item);
+        (*ok) = (p != NULL);
+        return p;
+    }
+
+    size_t size = blockSize(nitems_new, size_of_item);
+    if (size == 0)
+    {
+        (*ok) = 0;
+        return p;
+    }
+
+    BlockHeader *header = static_cast<BlockHeader *>(p) - 1;
+    size_t oldSize      = static_cast<size_t>(header->size);
+    void *block = SuiteSparse_realloc(sizeof(BlockHeader) + size,
+                                      sizeof(BlockHeader) + oldSize, 1, header,
+                                      ok);
+    if (!(*ok))
+        return p;
+
+    header = static_cast<BlockHeader *>(block);
+    uncountBlock(header);
+    return countBlock(header, size);
+}
+
+void *mongoose_free(void *p)
+{
+    if (p)
+    {
+        BlockHeader *header = static_cast<BlockHeader *>(p) - 1;
+        uncountBlock(header);
+        SuiteSparse_free(header);
+    }
+    return NULL;
+}
+
+/**
+ * Turn the accounting of the calling thread on or off.
+ *
+ * Only the thread-local state changes, so other threads may allocate, and
+ * turn their own accounting on and off, at the same time. Turning accounting
+ * off forgets the blocks counted, so the bytes in use start again from zero
+ * when it is turned back on; the peaks are kept until reset (see
+ * Logger::resetTiming).
+ */
+void MemoryAccounting::setAccountingFlag(bool aFlag)
+{
+    if (aFlag == accountingOn)
+        return;
+
+    accountingOn  = aFlag;
+    state.session = (aFlag) ? ++lastSession : 0;
+    state.inUse   = 0;
+}
+
+/* === Phases =============================================================== */
+
+void MemoryAccounting::begin(int timingType)
+{
+    state.running[timingType] = true;
+    state.update(0);
+}
+
+void MemoryAccounting::end(int timingType)
+{
+    state.running[timingType] = false;
+}
+
+/* The bytes in use in the blocks counted on this thread */
+Int MemoryAccounting::inUse()
+{
+    return state.inUse;
+}
+
+/* The most bytes in use on this thread since accounting was reset */
+Int MemoryAccounting::peak()
+{
+    return state.peak;
+}
+
+/* The most bytes in use while a timing type ran, at any coarsening level */
+Int MemoryAccounting::peak(int timingType)
+{
+    Int bytes = 0;
+    for (int l = 0; l < MaxLevels; l++)
+        bytes = std::max(bytes, state.peaks[l][timingType]);
+    return bytes;
+}
+
+/* The most bytes in use while a timing type ran at one coarsening level */
+Int MemoryAccounting::peak(int timingType, Int level)
+{
+    if (level < 0 || level >= MaxLevels)
+        return 0;
+    return state.peaks[level][timingType];
+}
+
+/* The total bytes allocated while a timing type ran, over all levels */
+Int MemoryAccounting::allocated(int timingType)
+{
+    Int bytes = 0;
+    for (int l = 0; l < MaxLevels; l++)
+        bytes += state.allocated[l][timingType];
+    return bytes;
+}
+
+/* The total bytes allocated while a timing type ran at one level */
+Int MemoryAccounting::allocated(int timingType, Int level)
+{
+    if (level < 0 || level >= MaxLevels)
+        return 0;
+    return state.allocated[level][timingType];
+}
+
+/**
+ * Start measuring the peak of a part of the computation.
+ *
+ * The peak is lowered to the bytes now in use, and the peak it replaces is
+ * returned; pass it to stopPeak at the end of that part, which gives the peak
+ * of the part and raises the peak back. Measurements may be nested.
+ */
+Int MemoryAccounting::startPeak()
+{
+    Int outerPeak = state.peak;
+    state.peak    = state.inUse;
+    return outerPeak;
+}
+
+Int MemoryAccounting::stopPeak(Int outerPeak)
+{
+    Int partPeak = state.peak;
+    state.peak   = std::max(outerPeak, partPeak);
+    return partPeak;
+}
+
+/* Clear the peaks and allocations recorded on this thread */
+void MemoryAccounting::reset()
+{
+    state.clear();
+    state.peak = state.inUse;
+}
+
+} // end namespace Mongoose
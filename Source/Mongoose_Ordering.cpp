@@ -0,0 +1,306 @@
+/* ========================================================================== */
+/* === Source/Mongoose_Ordering.cpp ========================================= */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+#include "Mongoose_Ordering.hpp"
+#include "Mongoose_Debug.hpp"
+
+#include <algorithm>
+
+namespace Mongoose
+{
+
+/* Orders vertices by increasing degree, breaking ties by number */
+struct DegreeLess
+{
+    const Int *Gp;
+    DegreeLess(const Int *_Gp) : Gp(_Gp) {}
+    bool operator()(Int a, Int b) const
+    {
+        Int da = Gp[a + 1] - Gp[a];
+        Int db = Gp[b + 1] - Gp[b];
+        return (da != db) ? (da < db) : (a < b);
+    }
+};
+
+/* Breadth-first search from start, stamping each vertex found with s and
+   appending it to queue. If byDegree, the neighbors found from each vertex
+   are appended in increasing order of degree (as in Cuthill-McKee). On
+   return, lastLevel is the position in queue of the first vertex of the
+   deepest level, and numLevels is the number of levels. Returns the number
+   of vertices found. */
+inline Int levelSearch(const Graph *graph, Int start, Int *queue, Int *stamp,
+                       Int s, bool byDegree, Int *lastLevel, Int *numLevels)
+{
+    Int *Gp = graph->p;
+    Int *Gi = graph->i;
+
+    Int head      = 0;
+    Int tail      = 0;
+    Int levels    = 0;
+    Int levelHead = 0;
+    queue[tail++] = start;
+    stamp[start]  = s;
+    while (head < tail)
+    {
+        Int levelEnd = tail;
+        levelHead    = head;
+        levels++;
+        for (; head < levelEnd; head++)
+        {
+            Int v     = queue[head];
+            Int found = tail;
+            for (Int p = Gp[v]; p < Gp[v + 1]; p++)
+            {
+                Int u = Gi[p];
+                if (stamp[u] != s)
+                {
+                    stamp[u]      = s;
+                    queue[tail++] = u;
+                }
+            }
+            if (byDegree)
+                std::sort(queue + found, queue + tail, DegreeLess(Gp));
+        }
+    }
+
+    *lastLevel = levelHead;
+    *numLevels = levels;
+    return tail;
+}
+
+/**
+ * @brief Compute a locality-improving ordering of the vertices of a graph
+ *
+ * Each connected component is numbered contiguously. With VertexOrdering_BFS
+ * the vertices of a component are numbered in breadth-first order from its
+ * lowest-numbered vertex. With VertexOrdering_RCM the search starts from a
+ * pseudo-peripheral vertex (found as in George and Liu), visits neighbors in
+ * increasing order of degree, and the whole ordering is then reversed.
+ *
+ * @param graph Graph to be ordered
+ * @param ordering The ordering to compute
+ * @return perm, of size n, where perm[k] is the vertex numbered k in the new
+ *         ordering, or NULL if out of memory.
+ */
+Int *vertexOrdering(const Graph *graph, VertexOrdering ordering)
+{
+    Int n   = graph->n;
+    Int *Gp = graph->p;
+
+    Int *perm  = (Int *)mongoose_malloc(static_cast<size_t>(n), sizeof(Int));
+    Int *stamp = (Int *)mongoose_calloc(static_cast<size_t>(n), sizeof(Int));
+    if (!perm || !stamp)
+    {
+        mongoose_free(perm);
+        mongoose_free(stamp);
+        return NULL;
+    }
+
+    bool rcm = (ordering == VertexOrdering_RCM);
+    Int s    = 0;
+    Int k    = 0;
+    for (Int start = 0; start < n; start++)
+    {
+        if (stamp[start] != 0)
+            continue;
+
+        /* The searches all use the unnumbered part of perm as their queue */
+        Int *queue = perm + k;
+        Int lastLevel, numLevels;
+        Int found = levelSearch(graph, start, queue, stamp, ++s, false,
+                                &lastLevel, &numLevels);
+
+        if (rcm)
+        {
+            /* Restart from a vertex of least degree in the deepest level
+               while that makes the level structure deeper. Each search
+               costs as much as the ordering itself, and two restarts are
+               usually enough to reach a pseudo-peripheral vertex. */
+            Int root = start;
+            for (Int search = 0; search < 2; search++)
+            {
+                Int candidate = *std::min_element(queue + lastLevel,
+                                                  queue + found, DegreeLess(Gp));
+                Int candidateLast, candidateLevels;
+                levelSearch(graph, candidate, queue, stamp, ++s, false,
+                            &candidateLast, &candidateLevels);
+                if (candidateLevels <= numLevels)
+                    break;
+                root      = candidate;
+                lastLevel = candidateLast;
+                numLevels = candidateLevels;
+            }
+            levelSearch(graph, root, queue, stamp, ++s, true, &lastLevel,
+                        &numLevels);
+        }
+
+        k += found;
+    }
+
+    if (rcm)
+        std::reverse(perm, perm + n);
+
+    mongoose_free(stamp);
+    return perm;
+}
+
+/**
+ * @brief Renumber a graph
+ *
+ * @param graph Graph to be renumbered
+ * @param perm Ordering from vertexOrdering: vertex perm[k] becomes vertex k
+ * @return A new graph with the vertices of @p graph renumbered, or NULL if
+ *         out of memory.
+ */
+Graph *permuteGraph(const Graph *graph, const Int *perm)
+{
+    Int n      = graph->n;
+    Int *Gp    = graph->p;
+    Int *Gi    = graph->i;
+    double *Gx = graph->x;
+    double *Gw = graph->w;
+
+    Int *iperm = (Int *)mongoose_malloc(static_cast<size_t>(n), sizeof(Int));
+    Graph *permuted = (iperm) ? Graph::create(n, Gp[n]) : NULL;
+    if (permuted)
+    {
+        permuted->x = (Gx) ? (double *)mongoose_malloc(
+                          static_cast<size_t>(Gp[n]), sizeof(double))
+                           : NULL;
+        permuted->w = (Gw) ? (double *)mongoose_malloc(
+                          static_cast<size_t>(n), sizeof(double))
+                           : NULL;
+        if ((Gx && !permuted->x) || (Gw && !permuted->w))
+        {
+            permuted->~Graph();
+            permuted = NULL;
+        }
+    }
+    if (!permuted)
+    {
+        mongoose_free(iperm);
+        return NULL;
+    }
+
+    for (Int k = 0; k < n; k++)
+        iperm[perm[k]] = k;
+
+    Int *Pp    = permuted->p;
+    Int *Pi    = permuted->i;
+    double *Px = permuted->x;
+    Int nz     = 0;
+    for (Int k = 0; k < n; k++)
+    {
+        Int v = perm[k];
+        Pp[k] = nz;
+        for (Int p = Gp[v]; p < Gp[v + 1]; p++)
+        {
+            Pi[nz] = iperm[Gi[p]];
+            if (Gx)
+                Px[nz] = Gx[p];
+            nz++;
+        }
+        if (Gw)
+            permuted->w[k] = Gw[v];
+    }
+    Pp[n] = nz;
+
+    mongoose_free(iperm);
+    return permuted;
+}
+
+/**
+ * @brief Partition a graph in a locality-improving vertex ordering
+ *
+ * The graph is renumbered by vertexOrdering, partitioned, and the partition
+ * is returned in the numbering of @p graph.
+ *
+ * @param graph Graph to be partitioned
+ * @param options Options, with vertex_ordering not VertexOrdering_Natural
+ * @return The edge cut of @p graph, or NULL if out of memory.
+ */
+EdgeCut *edgeCutOrdered(const Graph *graph, const EdgeCut_Options *options)
+{
+    Int n           = graph->n;
+    Int *perm       = vertexOrdering(graph, options->vertex_ordering);
+    Graph *permuted = (perm) ? permuteGraph(graph, perm) : NULL;
+    bool *partition
+        = (bool *)mongoose_malloc(static_cast<size_t>(n), sizeof(bool));
+    EdgeCutProblem *problem
+        = (permuted && partition) ? EdgeCutProblem::create(permuted) : NULL;
+
+    EdgeCut *result = (problem) ? edge_cut(problem, options) : NULL;
+
+    if (result)
+    {
+        for (Int k = 0; k < n; k++)
+            partition[perm[k]] = result->partition[k];
+        mongoose_free(result->partition);
+        result->partition = partition;
+        partition         = NULL;
+    }
+
+    if (problem)
+        problem->~EdgeCutProblem();
+    if (permuted)
+        permuted->~Graph();
+    mongoose_free(perm);
+    mongoose_free(partition);
+
+    return result;
+}
+
+/**
+ * @brief Number the vertices of the coarse graph in order of their first
+ *        fine vertex
+ *
+ * Matching creates coarse vertices in the order the matches are found, which
+ * after the first pass no longer follows the fine numbering. Renumbering them
+ * by their lowest-numbered fine vertex keeps the locality of the fine graph
+ * in the coarse graph. The lowest-numbered fine vertex of each coarse vertex
+ * becomes its representative in invmatchmap. If out of memory, the numbering
+ * is left as it is.
+ *
+ * @param graph Graph whose matching has been found but not yet coarsened
+ */
+void orderCoarseVertices(EdgeCutProblem *graph)
+{
+    Int n            = graph->n;
+    Int cn           = graph->cn;
+    Int *matchmap    = graph->matchmap;
+    Int *invmatchmap = graph->invmatchmap;
+
+    Int *newIndex
+        = (Int *)mongoose_malloc(static_cast<size_t>(cn), sizeof(Int));
+    if (!newIndex)
+        return;
+
+    for (Int c = 0; c < cn; c++)
+        newIndex[c] = -1;
+
+    Int next = 0;
+    for (Int k = 0; k < n; k++)
+    {
+        Int c = matchmap[k];
+        if (newIndex[c] < 0)
+        {
+            newIndex[c]       = next;
+            invmatchmap[next] = k;
+            next++;
+        }
+        matchmap[k] = newIndex[c];
+    }
+    ASSERT(next == cn);
+
+    mongoose_free(newIndex);
+}
+
+} // end namespace Mongoose
@@ -0,0 +1,272 @@
+/* ========================================================================== */
+/* === Source/Mongoose_PerfCounters.cpp ===================================== */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+#include "Mongoose_PerfCounters.hpp"
+#include "Mongoose_Logger.hpp"
+
+#include <cstring>
+
+#ifdef __linux__
+#define MONGOOSE_HAVE_PERF_EVENT
+#include <linux/perf_event.h>
+#include <stdint.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Mongoose
+{
+
+bool PerfCounters::countersOn = false;
+
+#ifdef MONGOOSE_HAVE_PERF_EVENT
+
+static const int NumCounters    = PerfCounters::NumCounters;
+static const int NumTimingTypes = Logger::NumTimingTypes;
+static const int MaxLevels      = Logger::MaxTimingLevels;
+
+/* The perf_event type and configuration of each counter */
+static const uint32_t counterTypes[NumCounters]
+    = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+        PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE };
+static const uint64_t counterConfigs[NumCounters]
+    = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) };
+
+/* The counters of one thread, read together as a single perf_event group */
+struct CounterGroup
+{
+    bool opened;    /* whether the counters have been opened      */
+    int leader;     /* fd of the group leader, or -1 if none      */
+    int fd[NumCounters];
+    uint64_t id[NumCounters];
+    double starts[NumTimingTypes][NumCounters]; /* counts at each tic */
+    double *counts; /* [level][timing type][counter], since reset */
+
+    CounterGroup() : opened(false), leader(-1), counts(NULL)
+    {
+        for (int c = 0; c < NumCounters; c++)
+            fd[c] = -1;
+    }
+
+    ~CounterGroup()
+    {
+        for (int c = 0; c < NumCounters; c++)
+        {
+            if (fd[c] >= 0)
+                close(fd[c]);
+        }
+        mongoose_free(counts);
+    }
+
+    /* Open the counters of this thread. Returns true if any could be. */
+    bool open()
+    {
+        if (opened)
+            return (leader >= 0);
+        opened = true;
+
+        counts = (double *)mongoose_calloc(
+            static_cast<size_t>(MaxLevels * NumTimingTypes * NumCounters),
+            sizeof(double));
+        if (!counts)
+            return false;
+
+        for (int c = 0; c < NumCounters; c++)
+        {
+            struct perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size           = sizeof(attr);
+            attr.type           = counterTypes[c];
+            attr.config         = counterConfigs[c];
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID
+                               | PERF_FORMAT_TOTAL_TIME_ENABLED
+                               | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            /* This thread, on any CPU */
+            fd[c] = static_cast<int>(
+                syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0));
+            if (fd[c] < 0)
+                continue;
+            if (ioctl(fd[c], PERF_EVENT_IOC_ID, &id[c]) != 0)
+            {
+                close(fd[c]);
+                fd[c] = -1;
+                continue;
+            }
+            if (leader < 0)
+                leader = fd[c];
+        }
+        return (leader >= 0);
+    }
+
+    /* Read the current value of each counter. When the kernel multiplexes
+       the counters, the values are scaled to the whole time enabled. */
+    bool read(double *values)
+    {
+        uint64_t buffer[3 + 2 * NumCounters];
+        if (::read(leader, buffer, sizeof(buffer)) <= 0)
+            return false;
+
+        uint64_t nr      = buffer[0];
+        uint64_t enabled = buffer[1];
+        uint64_t running = buffer[2];
+        double scale     = (running > 0) ? static_cast<double>(enabled)
+                                           / static_cast<double>(running)
+                                         : 0;
+        for (uint64_t e = 0; e < nr && e < NumCounters; e++)
+        {
+            uint64_t value = buffer[3 + 2 * e];
+            uint64_t eid   = buffer[4 + 2 * e];
+            for (int c = 0; c < NumCounters; c++)
+            {
+                if (fd[c] >= 0 && id[c] == eid)
+                    values[c] = static_cast<double>(value) * scale;
+            }
+        }
+        return true;
+    }
+};
+
+static thread_local CounterGroup group;
+
+/**
+ * Turn counting on or off for all threads.
+ *
+ * @param cFlag Whether to count
+ * @return true if any counter is available on the calling thread
+ */
+bool PerfCounters::setCountersFlag(bool cFlag)
+{
+    countersOn = cFlag;
+    return cFlag && group.open();
+}
+
+/* Read the counters at the beginning of a timed phase */
+void PerfCounters::begin(int timingType)
+{
+    if (group.open())
+        group.read(group.starts[timingType]);
+}
+
+/* Read the counters at the end of a timed phase, and charge the counts since
+   the matching begin to the timing type at the current level */
+void PerfCounters::end(int timingType)
+{
+    double values[NumCounters];
+    if (!group.open() || !group.read(values))
+        return;
+
+    double *counts = group.counts
+                     + (Logger::getTimingLevel() * NumTimingTypes + timingType)
+                           * NumCounters;
+    for (int c = 0; c < NumCounters; c++)
+    {
+        if (group.fd[c] >= 0)
+            counts[c] += values[c] - group.starts[timingType][c];
+    }
+}
+
+bool PerfCounters::isAvailable(PerfCounterType counter)
+{
+    return group.opened && group.counts && group.fd[counter] >= 0;
+}
+
+/**
+ * Get the count of a counter for a timing type at a coarsening level.
+ *
+ * @return The count on this thread since the last reset, or -1 if the
+ *         counter is not available
+ */
+double PerfCounters::get(int timingType, PerfCounterType counter, Int level)
+{
+    if (!isAvailable(counter))
+        return -1;
+    if (level < 0 || level >= MaxLevels)
+        return 0;
+    return group.counts[(level * NumTimingTypes + timingType) * NumCounters
+                        + counter];
+}
+
+/* The count of a counter for a timing type over all levels, or -1 */
+double PerfCounters::get(int timingType, PerfCounterType counter)
+{
+    if (!isAvailable(counter))
+        return -1;
+    double total = 0;
+    for (Int level = 0; level < MaxLevels; level++)
+        total += get(timingType, counter, level);
+    return total;
+}
+
+/* Clear the counts of this thread */
+void PerfCounters::reset()
+{
+    if (group.counts)
+    {
+        for (int k = 0; k < MaxLevels * NumTimingTypes * NumCounters; k++)
+            group.counts[k] = 0;
+    }
+}
+
+#else
+
+/* Hardware counters are only available on Linux */
+
+bool PerfCounters::setCountersFlag(bool cFlag)
+{
+    (void)cFlag;
+    return false;
+}
+
+void PerfCounters::begin(int timingType)
+{
+    (void)timingType;
+}
+
+void PerfCounters::end(int timingType)
+{
+    (void)timingType;
+}
+
+bool PerfCounters::isAvailable(PerfCounterType counter)
+{
+    (void)counter;
+    return false;
+}
+
+double PerfCounters::get(int timingType, PerfCounterType counter, Int level)
+{
+    (void)timingType;
+    (void)counter;
+    (void)level;
+    return -1;
+}
+
+double PerfCounters::get(int timingType, PerfCounterType counter)
+{
+    (void)timingType;
+    (void)counter;
+    return -1;
+}
+
+void PerfCounters::reset()
+{
+}
+
+#endif
+
+} // end namespace Mongoose
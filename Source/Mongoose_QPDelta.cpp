@@ -18,35 +18,38 @@ namespace Mongoose
 
 QPDelta *QPDelta::Create(Int numVars)
 {
-    QPDelta *ret = (QPDelta *)SuiteSparse_calloc(1, sizeof(QPDelta));
+    QPDelta *ret = (QPDelta *)mongoose_calloc(1, sizeof(QPDelta));
     if (!ret)
         return NULL;
 
-    ret->x = (double *)SuiteSparse_malloc(static_cast<size_t>(numVars),
-                                          sizeof(double));
+    ret->numVars = numVars;
+
+    ret->x = (double *)mongoose_malloc(static_cast<size_t>(numVars),
+                                       sizeof(double));
     ret->FreeSet_status
-        = (Int *)SuiteSparse_malloc(static_cast<size_t>(numVars), sizeof(Int));
-    ret->FreeSet_list = (Int *)SuiteSparse_malloc(
+        = (Int *)mongoose_malloc(static_cast<size_t>(numVars), sizeof(Int));
+    ret->FreeSet_list = (Int *)mongoose_malloc(
         static_cast<size_t>(numVars + 1), sizeof(Int));
-    ret->gradient = (double *)SuiteSparse_malloc(static_cast<size_t>(numVars),
-                                                 sizeof(double));
-    ret->D        = (double *)SuiteSparse_malloc(static_cast<size_t>(numVars),
-                                          sizeof(double));
+    ret->gradient = (double *)mongoose_malloc(static_cast<size_t>(numVars),
+                                              sizeof(double));
+    ret->D        = (double *)mongoose_malloc(static_cast<size_t>(numVars),
+                                       sizeof(double));
 
     for (int i = 0; i < WISIZE; i++)
     {
-        ret->wi[i] = (Int *)SuiteSparse_malloc(static_cast<size_t>(numVars + 1),
-                                               sizeof(Int));
+        ret->wi[i] = (Int *)mongoose_malloc(static_cast<size_t>(numVars + 1),
+                                            sizeof(Int));
     }
 
     for (Int i = 0; i < WXSIZE; i++)
     {
-        ret->wx[i] = (double *)SuiteSparse_malloc(static_cast<size_t>(numVars),
-                                                  sizeof(double));
+        ret->wx[i] = (double *)mongoose_malloc(static_cast<size_t>(numVars),
+                                               sizeof(double));
     }
 
 #ifndef NDEBUG
-    ret->check_cost = INFINITY;
+    ret->check_cost     = INFINITY;
+    ret->gradientOffset = NULL;
 #endif
 
     if (!ret->x || !ret->FreeSet_status || !ret->FreeSet_list || !ret->gradient
@@ -56,29 +59,37 @@ QPDelta *QPDelta::Create(Int numVars)
         || !ret->wx[0] || !ret->wx[1] || !ret->wx[2])
     {
         ret->~QPDelta();
-        ret = (QPDelta *)SuiteSparse_free(ret);
+        ret = (QPDelta *)mongoose_free(ret);
     }
 
     return ret;
 }
 
+/* The bytes allocated by Create for a workspace of numVars variables */
+size_t QPDelta::memoryEstimate(Int numVars)
+{
+    size_t n = static_cast<size_t>(numVars);
+    return sizeof(QPDelta) + (3 + WXSIZE) * n * sizeof(double)
+           + (n + (1 + WISIZE) * (n + 1)) * sizeof(Int);
+}
+
 QPDelta::~QPDelta()
 {
-    x              = (double *)SuiteSparse_free(x);
-    FreeSet_status = (Int *)SuiteSparse_free(FreeSet_status);
-    FreeSet_list   = (Int *)SuiteSparse_free(FreeSet_list);
-    gradient       = (double *)SuiteSparse_free(gradient);
-    D              = (double *)SuiteSparse_free(D);
-    // Change_location = (Int*) SuiteSparse_free(Change_location);
+    x              = (double *)mongoose_free(x);
+    FreeSet_status = (Int *)mongoose_free(FreeSet_status);
+    FreeSet_list   = (Int *)mongoose_free(FreeSet_list);
+    gradient       = (double *)mongoose_free(gradient);
+    D              = (double *)mongoose_free(D);
+    // Change_location = (Int*) mongoose_free(Change_location);
 
     for (Int i = 0; i < WISIZE; i++)
     {
-        wi[i] = (Int *)SuiteSparse_free(wi[i]);
+        wi[i] = (Int *)mongoose_free(wi[i]);
     }
 
     for (Int i = 0; i < WXSIZE; i++)
     {
-        wx[i] = (double *)SuiteSparse_free(wx[i]);
+        wx[i] = (double *)mongoose_free(wx[i]);
     }
 }
 
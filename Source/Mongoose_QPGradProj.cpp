@@ -25,20 +25,24 @@
 #include "Mongoose_Debug.hpp"
 #include "Mongoose_Internal.hpp"
 #include "Mongoose_Logger.hpp"
+#include "Mongoose_QPKernels.hpp"
 #include "Mongoose_QPNapsack.hpp"
 
 #define EMPTY (-1)
+#define NONMONOTONE_WINDOW 10
 
 namespace Mongoose
 {
 
 // save the current state of the solution, just before returning from QPGradProj
 inline void saveContext(EdgeCutProblem *graph, QPDelta *QP, Int it, double err,
-                        Int nFreeSet, Int ib, double lo, double hi)
+                        Int nFreeSet, Int ib, double lo, double hi,
+                        double lambda)
 {
     QP->its      = it;
     QP->err      = err;
     QP->nFreeSet = nFreeSet;
+    QP->lambda   = lambda; // warm start for the next napsack solve
     double b     = 0.0;
     if (ib != 0)
     {
@@ -55,6 +59,7 @@ inline void saveContext(EdgeCutProblem *graph, QPDelta *QP, Int it, double err,
 
 double QPGradProj(EdgeCutProblem *graph, const EdgeCut_Options *options, QPDelta *qpDelta)
 {
+    Trace::begin("QPGradProj", graph->n);
 
     PR(("\n------- QPGradProj start: [\n"));
     DEBUG(QPcheckCom(graph, options, qpDelta, 0, qpDelta->nFreeSet,
@@ -114,6 +119,16 @@ double QPGradProj(EdgeCutProblem *graph, const EdgeCut_Options *options, QPDelta
     Int it        = 0;
     double err    = INFINITY;
 
+    /* Acceleration: Barzilai-Borwein step lengths with a nonmonotone
+     * (Grippo-Lampariello-Lucidi) acceptance test. f tracks the change in
+     * the objective since the start, and fHistory its last few values. */
+    bool accelerate = options->gradproj_accelerate;
+    double bbStep   = 0.; /* BB step length, or 0 to use the Cauchy step */
+    double f        = 0.;
+    double fHistory[NONMONOTONE_WINDOW];
+    Int nHistory = 1;
+    fHistory[0]  = 0.;
+
     DEBUG(FreeSet_dump("QPGradProj: start", n, FreeSet_list, nFreeSet,
                        FreeSet_status, 0, x));
 
@@ -132,9 +147,10 @@ double QPGradProj(EdgeCutProblem *graph, const EdgeCut_Options *options, QPDelta
             // for debugging, just use malloc
             double s       = 0.;
             double *mygrad = (double *)malloc((n + 1) * sizeof(double));
+            double *offset = qpDelta->gradientOffset;
             for (Int k = 0; k < n; k++)
             {
-                mygrad[k] = (0.5 - x[k]) * D[k];
+                mygrad[k] = (0.5 - x[k]) * D[k] + ((offset) ? offset[k] : 0);
             }
             for (Int k = 0; k < n; k++)
             {
@@ -162,82 +178,87 @@ double QPGradProj(EdgeCutProblem *graph, const EdgeCut_Options *options, QPDelta
 #endif
 
         /* Moving in the gradient direction. */
-        for (Int k = 0; k < n; k++)
-            y[k] = x[k] - grad[k];
+        QPKernel_step(y, x, 1.0, grad, n);
 
         /* Run the napsack. */
         lambda = QPNapsack(y, n, lo, hi, Ew, lambda, FreeSet_status, wx, wi1,
-                           wi2, tol);
+                           wi2, tol, options->napsack_solver);
 
         /* Compute the maximum error. */
-        err = -INFINITY;
-        for (Int k = 0; k < n; k++)
-            err = std::max(err, fabs(y[k] - x[k]));
+        err = QPKernel_maxAbsDiff(y, x, n);
 
         /* If we converged or got exhausted, save context and exit. */
         if ((err <= tol) || (it >= limit))
         {
             PR(("QPGradProj exhausted:"));
-            saveContext(graph, qpDelta, it, err, nFreeSet, ib, lo, hi);
+            saveContext(graph, qpDelta, it, err, nFreeSet, ib, lo, hi, lambda);
             DEBUG(QPcheckCom(graph, options, qpDelta, 1, qpDelta->nFreeSet,
                              qpDelta->b));
             DEBUG(FreeSet_dump("QPGradProj exhausted", n, FreeSet_list,
                                nFreeSet, FreeSet_status, 0, x));
             PR(("------- QPGradProj end ]\n"));
+            Trace::end("QPGradProj");
             return err;
         }
 
         it++;
 
-        /* compute stepsize st = g_F'g_F/-g_F'(A+D)g_F */
-        for (Int k = 0; k < n; k++)
-            Dgrad[k] = 0.;
+        if (accelerate && bbStep > 0.)
+        {
+            /* take the BB step computed from the previous iteration */
+            QPKernel_step(y, x, bbStep, grad, n);
+            lambda = QPNapsack(y, n, lo, hi, Ew, lambda, FreeSet_status, wx,
+                               wi1, wi2, tol, options->napsack_solver);
+        }
+        else
+        {
+            /* compute stepsize st = g_F'g_F/-g_F'(A+D)g_F */
+            QPKernel_zero(Dgrad, n);
 
-        DEBUG(FreeSet_dump("QPGradProj:1", n, FreeSet_list, nFreeSet,
-                           FreeSet_status, 0, x));
+            DEBUG(FreeSet_dump("QPGradProj:1", n, FreeSet_list, nFreeSet,
+                               FreeSet_status, 0, x));
 
-        // for each i in the FreeSet:
-        for (Int ifree = 0; ifree < nFreeSet; ifree++)
-        {
-            /* compute -(A+D)g_F */
-            Int i    = FreeSet_list[ifree];
-            double s = grad[i];
-            for (Int p = Ep[i]; p < Ep[i + 1]; p++)
+            // for each i in the FreeSet:
+            for (Int ifree = 0; ifree < nFreeSet; ifree++)
             {
-                Dgrad[Ei[p]] -= s * ((Ex) ? Ex[p] : 1);
+                /* compute -(A+D)g_F */
+                Int i    = FreeSet_list[ifree];
+                double s = grad[i];
+                for (Int p = Ep[i]; p < Ep[i + 1]; p++)
+                {
+                    Dgrad[Ei[p]] -= s * ((Ex) ? Ex[p] : 1);
+                }
+                Dgrad[i] -= s * D[i];
             }
-            Dgrad[i] -= s * D[i];
-        }
 
-        double st_num = 0.;
-        double st_den = 0.;
+            double st_num = 0.;
+            double st_den = 0.;
 
-        DEBUG(FreeSet_dump("QPGradProj:2", n, FreeSet_list, nFreeSet,
-                           FreeSet_status, 0, x));
+            DEBUG(FreeSet_dump("QPGradProj:2", n, FreeSet_list, nFreeSet,
+                               FreeSet_status, 0, x));
 
-        for (Int jfree = 0; jfree < nFreeSet; jfree++)
-        {
-            Int j = FreeSet_list[jfree];
-            st_num += grad[j] * grad[j];
-            st_den += grad[j] * Dgrad[j];
-        }
+            for (Int jfree = 0; jfree < nFreeSet; jfree++)
+            {
+                Int j = FreeSet_list[jfree];
+                st_num += grad[j] * grad[j];
+                st_den += grad[j] * Dgrad[j];
+            }
 
-        /* st = g_F'g_F/-g_F'(A+D)g_F unless the denominator <= 0 */
-        if (st_den > 0.)
-        {
-            // PR (("change y\n")) ;
-            double st = std::max(st_num / st_den, 0.001);
-            for (Int j = 0; j < n; j++)
-                y[j] = x[j] - st * grad[j];
-            lambda = QPNapsack(y, n, lo, hi, Ew, lambda, FreeSet_status, wx,
-                               wi1, wi2, tol);
+            /* st = g_F'g_F/-g_F'(A+D)g_F unless the denominator <= 0 */
+            if (st_den > 0.)
+            {
+                // PR (("change y\n")) ;
+                double st = std::max(st_num / st_den, 0.001);
+                QPKernel_step(y, x, st, grad, n);
+                lambda = QPNapsack(y, n, lo, hi, Ew, lambda, FreeSet_status, wx,
+                                   wi1, wi2, tol, options->napsack_solver);
+            }
         }
 
         /* otherwise st = 1 and y is as computed above */
         Int nc   = 0; /* number of changes (number of j for which y_j != x_j) */
         double s = 0.;
-        for (Int j = 0; j < n; j++)
-            Dgrad[j] = 0.;
+        QPKernel_zero(Dgrad, n);
 
         // consider vertices j in the FreeSet_list
         for (Int jfree = 0; jfree < nFreeSet; jfree++)
@@ -295,10 +316,11 @@ double QPGradProj(EdgeCutProblem *graph, const EdgeCut_Options *options, QPDelta
         if (s >= 0.)
         {
             PR(("QPGradProj directional derivative has wrong sign\n"));
-            saveContext(graph, qpDelta, it, err, nFreeSet, ib, lo, hi);
+            saveContext(graph, qpDelta, it, err, nFreeSet, ib, lo, hi, lambda);
             DEBUG(FreeSet_dump("QPGradProj wrong sign", n, FreeSet_list,
                                nFreeSet, FreeSet_status, 0, x));
             PR(("------- QPGradProj end ]\n"));
+            Trace::end("QPGradProj");
             return err;
         }
 
@@ -345,8 +367,22 @@ double QPGradProj(EdgeCutProblem *graph, const EdgeCut_Options *options, QPDelta
 
         // PR (("MIN ATTAINED AT Y? s %g t %g s+t %g\n", s, t, s+t)) ;
 
-        if (s + t <= 0) /* min attained at y, slope at y <= 0 */
+        /* Take the full step to y if the minimum along the step is attained
+         * at y or, when accelerating, if f(y) is no worse than the largest
+         * recent objective value (the nonmonotone Armijo test). */
+        bool fullStep = (s + t <= 0);
+        if (!fullStep && accelerate)
         {
+            Int nRef    = std::min(nHistory, (Int)NONMONOTONE_WINDOW);
+            double fRef = fHistory[0];
+            for (Int k = 1; k < nRef; k++)
+                fRef = std::max(fRef, fHistory[k]);
+            fullStep = (f + s + 0.5 * t <= fRef + 1e-4 * s);
+        }
+
+        if (fullStep) /* move to y */
+        {
+            f += s + 0.5 * t;
             // PR (("min attained at y: s %g t %g s+t %g\n", s, t, s+t)) ;
             ib = (lambda > 0 ? 1 : lambda < 0 ? -1 : 0);
             for (Int k = 0; k < nc; k++)
@@ -436,10 +472,7 @@ double QPGradProj(EdgeCutProblem *graph, const EdgeCut_Options *options, QPDelta
                     FreeSet_status[j] = FreeSet_status_j;
                 }
             }
-            for (Int j = 0; j < n; j++)
-            {
-                grad[j] += Dgrad[j];
-            }
+            QPKernel_axpy(grad, 1.0, Dgrad, n);
         }
         else /* partial step towards y, st < 1 */
         {
@@ -449,6 +482,7 @@ double QPGradProj(EdgeCutProblem *graph, const EdgeCut_Options *options, QPDelta
             }
 
             double st = -s / t;
+            f -= 0.5 * s * s / t;
             // PR (("partial step towards y, st %g\n", st)) ;
             for (Int k = 0; k < nc; k++)
             {
@@ -467,10 +501,25 @@ double QPGradProj(EdgeCutProblem *graph, const EdgeCut_Options *options, QPDelta
                 x[j] += st * d[j];
             }
 
-            for (Int k = 0; k < n; k++)
+            QPKernel_axpy(grad, st, Dgrad, n);
+        }
+
+        if (accelerate)
+        {
+            fHistory[nHistory % NONMONOTONE_WINDOW] = f;
+            nHistory++;
+
+            /* The BB step is d'd / d'Hd (the step length cancels). With
+             * negative curvature along d, the objective keeps decreasing
+             * past y, so take the longest step allowed, as in spectral
+             * projected gradient methods. */
+            double dd = 0.;
+            for (Int k = 0; k < nc; k++)
             {
-                grad[k] += st * Dgrad[k];
+                Int j = changeList[k];
+                dd += d[j] * d[j];
             }
+            bbStep = (t > 0.) ? std::min(std::max(dd / t, 0.001), 1000.) : 1000.;
         }
 
         // prune any EMPTY entries from the FreeSet
@@ -500,6 +549,7 @@ double QPGradProj(EdgeCutProblem *graph, const EdgeCut_Options *options, QPDelta
                        FreeSet_status, 0, x));
 
     PR(("------- QPGradProj end ]\n"));
+    Trace::end("QPGradProj");
     return err;
 }
 
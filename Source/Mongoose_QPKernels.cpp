@@ -0,0 +1,482 @@
+/* ========================================================================== */
+/* === Source/Mongoose_QPKernels.cpp ======================================== */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+/* The AVX2 and AVX-512 kernels are compiled with function-level target
+ * attributes, so the library itself does not need to be built with -mavx2 and
+ * still runs on older CPUs. The kernels are chosen at run time from the CPU
+ * features reported by __builtin_cpu_supports. Other compilers and
+ * architectures get the scalar kernels only. */
+
+#include "Mongoose_QPKernels.hpp"
+
+#include <algorithm>
+
+#if (defined(__GNUC__) || defined(__clang__))                                  \
+    && (defined(__x86_64__) || defined(__i386__))
+#define MONGOOSE_QPKERNELS_X86
+#include <immintrin.h>
+#endif
+
+/* Every kernel must give bit-for-bit the same result as the scalar code, so
+ * that the partition does not depend on the CPU. The napsack slope is summed
+ * in the same order by every version: the terms of each full block of four
+ * go to four lanes, the lanes are added pairwise, and the remaining terms
+ * are added one at a time. AVX-512 implies FMA, so this file is built with
+ * -ffp-contract=off (see CMakeLists.txt) to keep the compiler from fusing
+ * multiplies and adds. */
+
+namespace Mongoose
+{
+
+/* ========================================================================== */
+/* === Scalar kernels ======================================================= */
+/* ========================================================================== */
+
+static void gradientInit_scalar(double *grad, const double *x, const double *D,
+                                Int n)
+{
+    for (Int k = 0; k < n; k++)
+        grad[k] = (0.5 - x[k]) * D[k];
+}
+
+static void step_scalar(double *y, const double *x, double st,
+                        const double *grad, Int n)
+{
+    for (Int k = 0; k < n; k++)
+        y[k] = x[k] - st * grad[k];
+}
+
+static void axpy_scalar(double *y, double st, const double *x, Int n)
+{
+    for (Int k = 0; k < n; k++)
+        y[k] += st * x[k];
+}
+
+static void zero_scalar(double *x, Int n)
+{
+    for (Int k = 0; k < n; k++)
+        x[k] = 0.;
+}
+
+static double maxAbsDiff_scalar(const double *y, const double *x, Int n)
+{
+    double err = -INFINITY;
+    for (Int k = 0; k < n; k++)
+        err = std::max(err, fabs(y[k] - x[k]));
+    return err;
+}
+
+/* a[k] * proj (x[k] - a[k]*lambda) */
+static inline double napsackTerm(const double *x, const double *a,
+                                 double lambda, Int k)
+{
+    double ak = (a) ? a[k] : 1;
+    double xi = x[k] - ak * lambda;
+    if (xi >= 1.)
+        return ak;
+    return (xi > 0.) ? ak * xi : 0.;
+}
+
+static double napsackSlope_scalar(const double *x, const double *a,
+                                  double lambda, Int n)
+{
+    double lanes[4] = { 0., 0., 0., 0. };
+    Int k           = 0;
+    for (; k + 4 <= n; k += 4)
+    {
+        for (Int l = 0; l < 4; l++)
+            lanes[l] += napsackTerm(x, a, lambda, k + l);
+    }
+    double slope = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    double tail  = 0.;
+    for (; k < n; k++)
+        tail += napsackTerm(x, a, lambda, k);
+    return slope + tail;
+}
+
+#ifdef MONGOOSE_QPKERNELS_X86
+
+/* ========================================================================== */
+/* === AVX2 kernels ========================================================= */
+/* ========================================================================== */
+
+#define MONGOOSE_AVX2 __attribute__((target("avx2")))
+
+MONGOOSE_AVX2
+static void gradientInit_avx2(double *grad, const double *x, const double *D,
+                              Int n)
+{
+    const __m256d half = _mm256_set1_pd(0.5);
+    Int k              = 0;
+    for (; k + 4 <= n; k += 4)
+    {
+        __m256d r = _mm256_sub_pd(half, _mm256_loadu_pd(x + k));
+        _mm256_storeu_pd(grad + k, _mm256_mul_pd(r, _mm256_loadu_pd(D + k)));
+    }
+    for (; k < n; k++)
+        grad[k] = (0.5 - x[k]) * D[k];
+}
+
+MONGOOSE_AVX2
+static void step_avx2(double *y, const double *x, double st, const double *grad,
+                      Int n)
+{
+    const __m256d s = _mm256_set1_pd(st);
+    Int k           = 0;
+    for (; k + 4 <= n; k += 4)
+    {
+        __m256d g = _mm256_mul_pd(s, _mm256_loadu_pd(grad + k));
+        _mm256_storeu_pd(y + k, _mm256_sub_pd(_mm256_loadu_pd(x + k), g));
+    }
+    for (; k < n; k++)
+        y[k] = x[k] - st * grad[k];
+}
+
+MONGOOSE_AVX2
+static void axpy_avx2(double *y, double st, const double *x, Int n)
+{
+    const __m256d s = _mm256_set1_pd(st);
+    Int k           = 0;
+    for (; k + 4 <= n; k += 4)
+    {
+        __m256d sx = _mm256_mul_pd(s, _mm256_loadu_pd(x + k));
+        _mm256_storeu_pd(y + k, _mm256_add_pd(_mm256_loadu_pd(y + k), sx));
+    }
+    for (; k < n; k++)
+        y[k] += st * x[k];
+}
+
+MONGOOSE_AVX2
+static void zero_avx2(double *x, Int n)
+{
+    const __m256d z = _mm256_setzero_pd();
+    Int k           = 0;
+    for (; k + 4 <= n; k += 4)
+        _mm256_storeu_pd(x + k, z);
+    for (; k < n; k++)
+        x[k] = 0.;
+}
+
+MONGOOSE_AVX2
+static double maxAbsDiff_avx2(const double *y, const double *x, Int n)
+{
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    __m256d vmax           = _mm256_set1_pd(-INFINITY);
+    Int k                  = 0;
+    for (; k + 4 <= n; k += 4)
+    {
+        __m256d d = _mm256_sub_pd(_mm256_loadu_pd(y + k),
+                                  _mm256_loadu_pd(x + k));
+        vmax      = _mm256_max_pd(vmax, _mm256_andnot_pd(signMask, d));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, vmax);
+    double err = std::max(std::max(lanes[0], lanes[1]),
+                          std::max(lanes[2], lanes[3]));
+    for (; k < n; k++)
+        err = std::max(err, fabs(y[k] - x[k]));
+    return err;
+}
+
+/* The napsack terms k to k+3, as napsackTerm computes them */
+MONGOOSE_AVX2
+static inline __m256d napsackTerms_avx2(const double *x, const double *a,
+                                        __m256d lam, Int k)
+{
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one  = _mm256_set1_pd(1.0);
+    if (!a)
+    {
+        __m256d xi = _mm256_sub_pd(_mm256_loadu_pd(x + k), lam);
+        return _mm256_min_pd(_mm256_max_pd(xi, zero), one);
+    }
+    __m256d ak = _mm256_loadu_pd(a + k);
+    __m256d xi = _mm256_sub_pd(_mm256_loadu_pd(x + k), _mm256_mul_pd(ak, lam));
+    xi         = _mm256_min_pd(_mm256_max_pd(xi, zero), one);
+    return _mm256_mul_pd(ak, xi);
+}
+
+/* Add the lanes of sum pairwise, then the terms k to n-1 one at a time */
+MONGOOSE_AVX2
+static inline double napsackFinish_avx2(__m256d sum, const double *x,
+                                        const double *a, double lambda, Int k,
+                                        Int n)
+{
+    double lanes[4];
+    _mm256_storeu_pd(lanes, sum);
+    double slope = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    double tail  = 0.;
+    for (; k < n; k++)
+        tail += napsackTerm(x, a, lambda, k);
+    return slope + tail;
+}
+
+MONGOOSE_AVX2
+static double napsackSlope_avx2(const double *x, const double *a, double lambda,
+                                Int n)
+{
+    const __m256d lam = _mm256_set1_pd(lambda);
+    __m256d sum       = _mm256_setzero_pd();
+    Int k             = 0;
+    for (; k + 4 <= n; k += 4)
+        sum = _mm256_add_pd(sum, napsackTerms_avx2(x, a, lam, k));
+    return napsackFinish_avx2(sum, x, a, lambda, k, n);
+}
+
+/* ========================================================================== */
+/* === AVX-512 kernels ====================================================== */
+/* ========================================================================== */
+
+/* The remainder of each vector is handled with masked loads and stores. */
+
+#define MONGOOSE_AVX512 __attribute__((target("avx512f")))
+
+MONGOOSE_AVX512
+static inline __mmask8 tailMask(Int k, Int n)
+{
+    return (__mmask8)((1u << (n - k)) - 1u);
+}
+
+MONGOOSE_AVX512
+static void gradientInit_avx512(double *grad, const double *x, const double *D,
+                                Int n)
+{
+    const __m512d half = _mm512_set1_pd(0.5);
+    for (Int k = 0; k < n; k += 8)
+    {
+        __mmask8 m = (k + 8 <= n) ? (__mmask8)0xFF : tailMask(k, n);
+        __m512d r  = _mm512_sub_pd(half, _mm512_maskz_loadu_pd(m, x + k));
+        _mm512_mask_storeu_pd(grad + k, m,
+                              _mm512_mul_pd(r, _mm512_maskz_loadu_pd(m, D + k)));
+    }
+}
+
+MONGOOSE_AVX512
+static void step_avx512(double *y, const double *x, double st,
+                        const double *grad, Int n)
+{
+    const __m512d s = _mm512_set1_pd(st);
+    for (Int k = 0; k < n; k += 8)
+    {
+        __mmask8 m = (k + 8 <= n) ? (__mmask8)0xFF : tailMask(k, n);
+        __m512d g  = _mm512_mul_pd(s, _mm512_maskz_loadu_pd(m, grad + k));
+        _mm512_mask_storeu_pd(
+            y + k, m, _mm512_sub_pd(_mm512_maskz_loadu_pd(m, x + k), g));
+    }
+}
+
+MONGOOSE_AVX512
+static void axpy_avx512(double *y, double st, const double *x, Int n)
+{
+    const __m512d s = _mm512_set1_pd(st);
+    for (Int k = 0; k < n; k += 8)
+    {
+        __mmask8 m = (k + 8 <= n) ? (__mmask8)0xFF : tailMask(k, n);
+        __m512d sx = _mm512_mul_pd(s, _mm512_maskz_loadu_pd(m, x + k));
+        _mm512_mask_storeu_pd(
+            y + k, m, _mm512_add_pd(_mm512_maskz_loadu_pd(m, y + k), sx));
+    }
+}
+
+MONGOOSE_AVX512
+static void zero_avx512(double *x, Int n)
+{
+    const __m512d z = _mm512_setzero_pd();
+    for (Int k = 0; k < n; k += 8)
+    {
+        __mmask8 m = (k + 8 <= n) ? (__mmask8)0xFF : tailMask(k, n);
+        _mm512_mask_storeu_pd(x + k, m, z);
+    }
+}
+
+MONGOOSE_AVX512
+static double maxAbsDiff_avx512(const double *y, const double *x, Int n)
+{
+    if (n == 0)
+        return -INFINITY;
+
+    // Masked-off lanes load as zero, which cannot exceed max |y - x| >= 0.
+    __m512d vmax = _mm512_setzero_pd();
+    for (Int k = 0; k < n; k += 8)
+    {
+        __mmask8 m = (k + 8 <= n) ? (__mmask8)0xFF : tailMask(k, n);
+        __m512d d  = _mm512_sub_pd(_mm512_maskz_loadu_pd(m, y + k),
+                                  _mm512_maskz_loadu_pd(m, x + k));
+        vmax       = _mm512_max_pd(vmax, _mm512_abs_pd(d));
+    }
+    return _mm512_reduce_max_pd(vmax);
+}
+
+/* The terms are computed eight at a time, and added to four lanes in the
+   order of the scalar kernel: the lower half of each block, then the upper. */
+MONGOOSE_AVX512
+static double napsackSlope_avx512(const double *x, const double *a,
+                                  double lambda, Int n)
+{
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d one  = _mm512_set1_pd(1.0);
+    const __m512d lam  = _mm512_set1_pd(lambda);
+    __m256d sum        = _mm256_setzero_pd();
+    Int k              = 0;
+    for (; k + 8 <= n; k += 8)
+    {
+        __m512d xi, t;
+        if (a)
+        {
+            __m512d ak = _mm512_loadu_pd(a + k);
+            xi = _mm512_sub_pd(_mm512_loadu_pd(x + k), _mm512_mul_pd(ak, lam));
+            t  = _mm512_mul_pd(ak, _mm512_min_pd(_mm512_max_pd(xi, zero), one));
+        }
+        else
+        {
+            xi = _mm512_sub_pd(_mm512_loadu_pd(x + k), lam);
+            t  = _mm512_min_pd(_mm512_max_pd(xi, zero), one);
+        }
+        sum = _mm256_add_pd(sum, _mm512_castpd512_pd256(t));
+        sum = _mm256_add_pd(sum, _mm512_extractf64x4_pd(t, 1));
+    }
+    if (k + 4 <= n)
+    {
+        sum = _mm256_add_pd(
+            sum, napsackTerms_avx2(x, a, _mm512_castpd512_pd256(lam), k));
+        k += 4;
+    }
+    return napsackFinish_avx2(sum, x, a, lambda, k, n);
+}
+
+#endif // MONGOOSE_QPKERNELS_X86
+
+/* ========================================================================== */
+/* === Dispatch ============================================================= */
+/* ========================================================================== */
+
+struct QPKernelTable
+{
+    QPKernelISA isa;
+    void (*gradientInit)(double *, const double *, const double *, Int);
+    void (*step)(double *, const double *, double, const double *, Int);
+    void (*axpy)(double *, double, const double *, Int);
+    void (*zero)(double *, Int);
+    double (*maxAbsDiff)(const double *, const double *, Int);
+    double (*napsackSlope)(const double *, const double *, double, Int);
+};
+
+static const QPKernelTable scalarKernels
+    = { QPKernelISA_Scalar, gradientInit_scalar, step_scalar,
+        axpy_scalar,        zero_scalar,         maxAbsDiff_scalar,
+        napsackSlope_scalar };
+
+#ifdef MONGOOSE_QPKERNELS_X86
+static const QPKernelTable avx2Kernels
+    = { QPKernelISA_AVX2, gradientInit_avx2, step_avx2,
+        axpy_avx2,        zero_avx2,         maxAbsDiff_avx2,
+        napsackSlope_avx2 };
+
+static const QPKernelTable avx512Kernels
+    = { QPKernelISA_AVX512, gradientInit_avx512, step_avx512,
+        axpy_avx512,        zero_avx512,         maxAbsDiff_avx512,
+        napsackSlope_avx512 };
+#endif
+
+static bool isaSupported(QPKernelISA isa)
+{
+#ifdef MONGOOSE_QPKERNELS_X86
+    __builtin_cpu_init();
+    switch (isa)
+    {
+    case QPKernelISA_AVX512:
+        return __builtin_cpu_supports("avx512f");
+    case QPKernelISA_AVX2:
+        return __builtin_cpu_supports("avx2");
+    default:
+        return true;
+    }
+#else
+    return (isa == QPKernelISA_Scalar);
+#endif
+}
+
+static const QPKernelTable *kernelsFor(QPKernelISA isa)
+{
+#ifdef MONGOOSE_QPKERNELS_X86
+    if (isa == QPKernelISA_AVX512)
+        return &avx512Kernels;
+    if (isa == QPKernelISA_AVX2)
+        return &avx2Kernels;
+#endif
+    return &scalarKernels;
+}
+
+static const QPKernelTable *detectKernels()
+{
+    if (isaSupported(QPKernelISA_AVX512))
+        return kernelsFor(QPKernelISA_AVX512);
+    if (isaSupported(QPKernelISA_AVX2))
+        return kernelsFor(QPKernelISA_AVX2);
+    return &scalarKernels;
+}
+
+static const QPKernelTable *activeKernels = NULL;
+
+static inline const QPKernelTable *kernels()
+{
+    if (!activeKernels)
+        activeKernels = detectKernels();
+    return activeKernels;
+}
+
+void QPKernel_gradientInit(double *grad, const double *x, const double *D,
+                           Int n)
+{
+    kernels()->gradientInit(grad, x, D, n);
+}
+
+void QPKernel_step(double *y, const double *x, double st, const double *grad,
+                   Int n)
+{
+    kernels()->step(y, x, st, grad, n);
+}
+
+void QPKernel_axpy(double *y, double st, const double *x, Int n)
+{
+    kernels()->axpy(y, st, x, n);
+}
+
+void QPKernel_zero(double *x, Int n)
+{
+    kernels()->zero(x, n);
+}
+
+double QPKernel_maxAbsDiff(const double *y, const double *x, Int n)
+{
+    return kernels()->maxAbsDiff(y, x, n);
+}
+
+double QPKernel_napsackSlope(const double *x, const double *a, double lambda,
+                             Int n)
+{
+    return kernels()->napsackSlope(x, a, lambda, n);
+}
+
+QPKernelISA QPKernel_getISA()
+{
+    return kernels()->isa;
+}
+
+bool QPKernel_setISA(QPKernelISA isa)
+{
+    if (!isaSupported(isa))
+        return false;
+    activeKernels = kernelsFor(isa);
+    return true;
+}
+
+} // end namespace Mongoose
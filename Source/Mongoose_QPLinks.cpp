@@ -12,6 +12,7 @@
 #include "Mongoose_Debug.hpp"
 #include "Mongoose_QPLinks.hpp"
 #include "Mongoose_Internal.hpp"
+#include "Mongoose_QPKernels.hpp"
 
 namespace Mongoose
 {
@@ -41,10 +42,7 @@ bool QPLinks(EdgeCutProblem *graph, const EdgeCut_Options *options, QPDelta *QP)
 
     double s = 0.; // a'x
 
-    for (Int k = 0; k < n; k++)
-    {
-        grad[k] = (0.5 - x[k]) * D[k];
-    }
+    QPKernel_gradientInit(grad, x, D, n);
 
     for (Int k = 0; k < n; k++)
     {
@@ -0,0 +1,192 @@
+/* ========================================================================== */
+/* === Source/Mongoose_QPNapSelect.cpp ====================================== */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+/* ========================================================================== */
+/* === QPNapSelect ========================================================== */
+/* ========================================================================== */
+/* Find the lambda in [lambda_lo, lambda_hi] for which the slope of the dual
+   function, neglecting b,
+
+       s (lambda) = a'proj (y - lambda*a),
+
+   is equal to b. This is an alternative to QPNapUp and QPNapDown (see the
+   napsack comments) that uses selection rather than heaps, in the style of
+   Brucker and Kiwiel.
+
+   Each x_i (lambda) has two breakpoints: it leaves 1 at (y_i - 1)/a_i and
+   reaches 0 at y_i/a_i. Since a > 0, s (lambda) is continuous and
+   nonincreasing. An index is "undecided" if one of its breakpoints lies
+   strictly inside the current bracket [lambda_lo, lambda_hi]; all other
+   indices contribute to s (lambda) as either a constant (x_i = 1 or 0) or a
+   linear term (0 < x_i < 1) over the whole bracket, and are summed once.
+
+   At each step, the median of the active breakpoints (the lowest breakpoint
+   of each undecided index inside the bracket) is found with nth_element, the
+   slope is evaluated there over the undecided indices only, and the bracket
+   is halved accordingly. At least half of the active breakpoints leave the
+   bracket at each step, so the total work is O(n) expected, compared with
+   O(n + h log n) for the heap-based search. Once no breakpoints remain, s is
+   linear on the bracket and lambda is found directly. */
+
+#include "Mongoose_QPNapSelect.hpp"
+#include "Mongoose_Debug.hpp"
+#include "Mongoose_Internal.hpp"
+#include "Mongoose_Logger.hpp"
+
+#include <algorithm>
+
+namespace Mongoose
+{
+
+double QPNapSelect      /* return lambda */
+    (const double *x,   /* holds y on input, not modified */
+     const Int n,       /* size of x */
+     double lambda_lo,  /* lower bound on lambda (may be -INFINITY) */
+     double lambda_hi,  /* upper bound on lambda (may be +INFINITY) */
+     const double *a,   /* input constraint vector */
+     double b,          /* input constraint scalar */
+     double *breakpts,  /* work array of size n */
+     Int *undecided     /* work array of size n */
+    )
+{
+    double lo = lambda_lo;
+    double hi = lambda_hi;
+    ASSERT(lo <= hi);
+
+    /* s (lambda) = sum1 + asum - lambda * a2sum for the decided indices */
+    double sum1  = 0.; // sum of a_i with x_i = 1 on the bracket
+    double asum  = 0.; // sum of a_i * y_i with x_i free on the bracket
+    double a2sum = 0.; // sum of a_i^2 with x_i free on the bracket
+
+    /* ---------------------------------------------------------------------- */
+    /* classify each index against the initial bracket */
+    /* ---------------------------------------------------------------------- */
+
+    Int nu = 0;
+    for (Int i = 0; i < n; i++)
+    {
+        double ai = (a) ? a[i] : 1;
+        double t1 = (x[i] - 1.) / ai; // x_i (lambda) < 1 for lambda > t1
+        double t0 = x[i] / ai;        // x_i (lambda) > 0 for lambda < t0
+        if (t1 >= hi)
+        {
+            sum1 += ai;
+        }
+        else if (t0 <= lo)
+        {
+            // x_i = 0 on the whole bracket
+        }
+        else if (t1 <= lo && t0 >= hi)
+        {
+            asum += ai * x[i];
+            a2sum += ai * ai;
+        }
+        else
+        {
+            undecided[nu++] = i;
+        }
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* shrink the bracket until no breakpoints remain inside it */
+    /* ---------------------------------------------------------------------- */
+
+    while (nu > 0)
+    {
+        for (Int k = 0; k < nu; k++)
+        {
+            Int i       = undecided[k];
+            double ai   = (a) ? a[i] : 1;
+            double t1   = (x[i] - 1.) / ai;
+            breakpts[k] = (t1 > lo) ? t1 : x[i] / ai;
+        }
+
+        std::nth_element(breakpts, breakpts + nu / 2, breakpts + nu);
+        double lambda = breakpts[nu / 2];
+
+        double s = sum1 + asum - lambda * a2sum;
+        for (Int k = 0; k < nu; k++)
+        {
+            Int i     = undecided[k];
+            double ai = (a) ? a[i] : 1;
+            double xi = x[i] - ai * lambda;
+            if (xi >= 1.)
+            {
+                s += ai;
+            }
+            else if (xi > 0.)
+            {
+                s += ai * xi;
+            }
+        }
+
+        if (s == b)
+        {
+            return lambda;
+        }
+        else if (s > b)
+        {
+            lo = lambda;
+        }
+        else
+        {
+            hi = lambda;
+        }
+
+        /* Move indices whose breakpoints have left the bracket. */
+        Int nu2 = 0;
+        for (Int k = 0; k < nu; k++)
+        {
+            Int i     = undecided[k];
+            double ai = (a) ? a[i] : 1;
+            double t1 = (x[i] - 1.) / ai;
+            double t0 = x[i] / ai;
+            if (t1 >= hi)
+            {
+                sum1 += ai;
+            }
+            else if (t0 <= lo)
+            {
+                // x_i = 0 on the whole bracket
+            }
+            else if (t1 <= lo && t0 >= hi)
+            {
+                asum += ai * x[i];
+                a2sum += ai * ai;
+            }
+            else
+            {
+                undecided[nu2++] = i;
+            }
+        }
+        nu = nu2;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* s is linear on the bracket: solve s (lambda) = b */
+    /* ---------------------------------------------------------------------- */
+
+    double lambda;
+    if (a2sum != 0.)
+    {
+        lambda = (sum1 + asum - b) / a2sum;
+        lambda = std::max(lo, std::min(lambda, hi));
+    }
+    else
+    {
+        // s is constant on the bracket, so any lambda in it will do
+        lambda = (lo > -INFINITY) ? lo : (hi < INFINITY) ? hi : 0.;
+    }
+
+    return lambda;
+}
+
+} // end namespace Mongoose
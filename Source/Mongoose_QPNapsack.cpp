@@ -81,7 +81,9 @@
     elements move from the free set to the opposite boundary.  A heap is used
     to hold the entries in the boundary and in the free set.  If the slope
     vanishes at either the starting lambda or at lambda = 0, then no heap is
-    constructed, and the time is just O (n).
+    constructed, and the time is just O (n).  With solver equal to
+    NapsackSolver_Selection, the heaps are replaced by a median-of-breakpoints
+    search (QPNapSelect), which takes O (n) expected time.
 
     If we have a guess for which components of x will be free at the optimal
     solution, then we can obtain a good guess for the starting lambda by
@@ -95,14 +97,40 @@
 #include "Mongoose_Debug.hpp"
 #include "Mongoose_Internal.hpp"
 #include "Mongoose_Logger.hpp"
+#include "Mongoose_QPKernels.hpp"
 #include "Mongoose_QPNapDown.hpp"
 #include "Mongoose_QPNapUp.hpp"
+#include "Mongoose_QPNapSelect.hpp"
 
 #include <cfloat>
 
 namespace Mongoose
 {
 
+/* Increase lambda until the slope of the dual function (neglecting b) is b */
+inline double napUp(const double *x, Int n, double lambda, const double *a,
+                    double b, double *w, Int *heap1, Int *heap2,
+                    NapsackSolver solver)
+{
+    if (solver == NapsackSolver_Selection)
+    {
+        return QPNapSelect(x, n, lambda, INFINITY, a, b, w, heap1);
+    }
+    return QPNapUp(x, n, lambda, a, b, w, heap1, heap2);
+}
+
+/* Decrease lambda until the slope of the dual function (neglecting b) is b */
+inline double napDown(const double *x, Int n, double lambda, const double *a,
+                      double b, double *w, Int *heap1, Int *heap2,
+                      NapsackSolver solver)
+{
+    if (solver == NapsackSolver_Selection)
+    {
+        return QPNapSelect(x, n, -INFINITY, lambda, a, b, w, heap1);
+    }
+    return QPNapDown(x, n, lambda, a, b, w, heap1, heap2);
+}
+
 #ifndef NDEBUG
 void checkatx(double *x, double *a, Int n, double lo, double hi, double tol)
 {
@@ -163,10 +191,12 @@ double QPNapsack    /* return the final lambda */
      double *w,  /* work array of size n   */
      Int *heap1, /* work array of size n+1 */
      Int *heap2, /* work array of size n+1 */
-     double tol  /* Gradient projection tolerance */
+     double tol, /* Gradient projection tolerance */
+     NapsackSolver solver /* heap-based or selection-based search */
     )
 {
     (void)tol; // unused variable except during debug
+    Trace::begin("QPNapsack", n);
     double lambda = Lambda;
     PR(("QPNapsack start [\n"));
 
@@ -201,19 +231,7 @@ double QPNapsack    /* return the final lambda */
     /* compute the initial slope */
     /* ---------------------------------------------------------------------- */
 
-    double slope = 0;
-    for (Int k = 0; k < n; k++)
-    {
-        double xi = x[k] - ((Gw) ? Gw[k] : 1) * lambda;
-        if (xi >= 1.)
-        {
-            slope += ((Gw) ? Gw[k] : 1);
-        }
-        else if (xi > 0.)
-        {
-            slope += ((Gw) ? Gw[k] : 1) * xi;
-        }
-    }
+    double slope = QPKernel_napsackSlope(x, Gw, lambda, n);
     PR(("slope %g lo %g hi %g\n", slope, lo, hi));
 
     /* remember: must still adjust slope by "-hi" or "-lo" for its final value
@@ -224,7 +242,7 @@ double QPNapsack    /* return the final lambda */
         if (slope > hi)
         {
             PR(("napsack case 1 up\n"));
-            lambda = QPNapUp(x, n, lambda, Gw, hi, w, heap1, heap2);
+            lambda = napUp(x, n, lambda, Gw, hi, w, heap1, heap2, solver);
             lambda = std::max(0., lambda);
         }
         else
@@ -237,7 +255,7 @@ double QPNapsack    /* return the final lambda */
         if (slope < lo)
         {
             PR(("napsack case 2 down\n"));
-            lambda = QPNapDown(x, n, lambda, Gw, lo, w, heap1, heap2);
+            lambda = napDown(x, n, lambda, Gw, lo, w, heap1, heap2, solver);
             lambda = std::min(lambda, 0.);
         }
         else
@@ -249,19 +267,7 @@ double QPNapsack    /* return the final lambda */
     {
         if (lambda != 0.)
         {
-            double slope0 = 0.;
-            for (Int k = 0; k < n; k++)
-            {
-                double xi = x[k];
-                if (xi >= 1.)
-                {
-                    slope0 += ((Gw) ? Gw[k] : 1);
-                }
-                else if (xi > 0.)
-                {
-                    slope0 += ((Gw) ? Gw[k] : 1) * xi;
-                }
-            }
+            double slope0 = QPKernel_napsackSlope(x, Gw, 0., n);
 
             if ((lambda >= 0) && (slope < hi)) /* case 3 */
             {
@@ -269,7 +275,8 @@ double QPNapsack    /* return the final lambda */
                 {
                     PR(("napsack case 3a down\n"));
                     lambda = 0.;
-                    lambda = QPNapDown(x, n, lambda, Gw, lo, w, heap1, heap2);
+                    lambda = napDown(x, n, lambda, Gw, lo, w, heap1, heap2,
+                                     solver);
                     if (lambda > 0.)
                     {
                         lambda = 0.;
@@ -278,7 +285,8 @@ double QPNapsack    /* return the final lambda */
                 else if (slope0 > hi)
                 {
                     PR(("napsack case 3b down\n"));
-                    lambda = QPNapDown(x, n, lambda, Gw, hi, w, heap1, heap2);
+                    lambda = napDown(x, n, lambda, Gw, hi, w, heap1, heap2,
+                                     solver);
                     if (lambda < 0.)
                         lambda = 0.;
                 }
@@ -294,13 +302,15 @@ double QPNapsack    /* return the final lambda */
                 {
                     PR(("napsack case 4a up\n"));
                     lambda = 0.;
-                    lambda = QPNapUp(x, n, lambda, Gw, hi, w, heap1, heap2);
+                    lambda = napUp(x, n, lambda, Gw, hi, w, heap1, heap2,
+                                   solver);
                     lambda = std::max(lambda, 0.);
                 }
                 else if (slope0 < lo)
                 {
                     PR(("napsack case 4b up\n"));
-                    lambda = QPNapUp(x, n, lambda, Gw, lo, w, heap1, heap2);
+                    lambda = napUp(x, n, lambda, Gw, lo, w, heap1, heap2,
+                                   solver);
                     lambda = std::min(0., lambda);
                 }
                 else
@@ -317,7 +327,8 @@ double QPNapsack    /* return the final lambda */
                 if (slope < lo)
                 {
                     PR(("napsack case 3d down\n"));
-                    lambda = QPNapDown(x, n, lambda, Gw, lo, w, heap1, heap2);
+                    lambda = napDown(x, n, lambda, Gw, lo, w, heap1, heap2,
+                                     solver);
                     lambda = std::min(0., lambda);
                 }
                 else
@@ -330,7 +341,8 @@ double QPNapsack    /* return the final lambda */
                 if (slope > hi)
                 {
                     PR(("napsack case 4d up\n"));
-                    lambda = QPNapUp(x, n, lambda, Gw, hi, w, heap1, heap2);
+                    lambda = napUp(x, n, lambda, Gw, hi, w, heap1, heap2,
+                                   solver);
                     lambda = std::max(lambda, 0.);
                 }
                 else
@@ -402,6 +414,7 @@ double QPNapsack    /* return the final lambda */
 
     PR(("QPNapsack done ]\n"));
 
+    Trace::end("QPNapsack");
     return lambda;
 }
 
@@ -0,0 +1,464 @@
+/* ========================================================================== */
+/* === Source/Mongoose_Reduction.cpp ======================================== */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+#include "Mongoose_Reduction.hpp"
+#include "Mongoose_Logger.hpp"
+
+#include <algorithm>
+#include <stdint.h>
+
+namespace Mongoose
+{
+
+/* A vertex with the degree and hash of its neighborhood. Sorting these
+   makes twins adjacent. */
+struct TwinKey
+{
+    Int degree;
+    uint64_t hash;
+    Int vertex;
+
+    bool sameNeighborhood(const TwinKey &other) const
+    {
+        return (degree == other.degree && hash == other.hash);
+    }
+    bool operator<(const TwinKey &other) const
+    {
+        if (degree != other.degree)
+            return (degree < other.degree);
+        if (hash != other.hash)
+            return (hash < other.hash);
+        return (vertex < other.vertex);
+    }
+};
+
+/* A well-mixed 64-bit hash of a vertex number (the splitmix64 finalizer) */
+inline uint64_t mixVertex(Int v)
+{
+    uint64_t z = static_cast<uint64_t>(v) + 0x9e3779b97f4a7c15ULL;
+    z          = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z          = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Fold chains of degree-1 vertices into their neighbors
+ *
+ * A vertex with a single neighbor is merged into that neighbor, which may in
+ * turn be left with a single neighbor, so trees hanging off the graph are
+ * folded up to their root. No merged vertex may weigh more than maxWeight.
+ *
+ * @param graph Graph to be reduced
+ * @param maxWeight Largest weight of a merged vertex
+ * @param map On output, map[k] is the vertex of the reduced graph that
+ *        contains vertex k. Unmerged vertices keep their relative order.
+ * @return The number of vertices of the reduced graph, or -1 if out of
+ *         memory.
+ */
+Int foldLeaves(const Graph *graph, double maxWeight, Int *map)
+{
+    Int n      = graph->n;
+    Int *Gp    = graph->p;
+    Int *Gi    = graph->i;
+    double *Gw = graph->w;
+
+    size_t size    = static_cast<size_t>(n);
+    Int *degree    = (Int *)mongoose_malloc(size, sizeof(Int));
+    Int *parent    = (Int *)mongoose_malloc(size, sizeof(Int));
+    Int *queue     = (Int *)mongoose_malloc(size, sizeof(Int));
+    double *weight = (double *)mongoose_malloc(size, sizeof(double));
+    if (!degree || !parent || !queue || !weight)
+    {
+        mongoose_free(degree);
+        mongoose_free(parent);
+        mongoose_free(queue);
+        mongoose_free(weight);
+        return -1;
+    }
+
+    /* degree[k] is the number of neighbors of k not yet folded. A vertex
+       enters the queue when its degree first becomes one, so at most once. */
+    Int tail = 0;
+    for (Int k = 0; k < n; k++)
+    {
+        parent[k] = -1;
+        degree[k] = Gp[k + 1] - Gp[k];
+        weight[k] = (Gw) ? Gw[k] : 1;
+        if (degree[k] == 1)
+            queue[tail++] = k;
+    }
+
+    for (Int head = 0; head < tail; head++)
+    {
+        Int leaf = queue[head];
+        if (parent[leaf] >= 0 || degree[leaf] != 1)
+            continue;
+
+        /* Neighbors already folded into leaf are skipped; the one left is
+           the only unfolded neighbor */
+        Int root = -1;
+        for (Int p = Gp[leaf]; p < Gp[leaf + 1] && root < 0; p++)
+        {
+            if (parent[Gi[p]] < 0)
+                root = Gi[p];
+        }
+        if (weight[root] + weight[leaf] > maxWeight)
+            continue;
+
+        parent[leaf] = root;
+        weight[root] += weight[leaf];
+        if (--degree[root] == 1)
+            queue[tail++] = root;
+    }
+
+    /* Number the unfolded vertices, reusing degree, then map each folded
+       vertex to the number of its root */
+    Int cn = 0;
+    for (Int k = 0; k < n; k++)
+    {
+        if (parent[k] < 0)
+            degree[k] = cn++;
+    }
+    for (Int k = 0; k < n; k++)
+    {
+        Int root = k;
+        while (parent[root] >= 0)
+            root = parent[root];
+        for (Int v = k; parent[v] >= 0;)
+        {
+            Int next  = parent[v];
+            parent[v] = root;
+            v         = next;
+        }
+        map[k] = degree[root];
+    }
+
+    mongoose_free(degree);
+    mongoose_free(parent);
+    mongoose_free(queue);
+    mongoose_free(weight);
+
+    return cn;
+}
+
+/**
+ * @brief Merge vertices with identical neighborhoods
+ *
+ * Two vertices are twins if they have the same set of neighbors (and so are
+ * not adjacent to each other). Candidates are found by sorting the vertices
+ * by degree and a hash of their neighborhood, and then checked exactly. Each
+ * set of twins is merged into super-vertices of weight at most maxWeight.
+ *
+ * @param graph Graph to be reduced
+ * @param maxWeight Largest weight of a merged vertex
+ * @param map On output, map[k] is the vertex of the reduced graph that
+ *        contains vertex k, numbered in order of their first vertex.
+ * @return The number of vertices of the reduced graph, or -1 if out of
+ *         memory.
+ */
+Int mergeTwins(const Graph *graph, double maxWeight, Int *map)
+{
+    Int n      = graph->n;
+    Int *Gp    = graph->p;
+    Int *Gi    = graph->i;
+    double *Gw = graph->w;
+
+    size_t size  = static_cast<size_t>(n);
+    TwinKey *key = (TwinKey *)mongoose_malloc(size, sizeof(TwinKey));
+    Int *stamp   = (Int *)mongoose_calloc(size, sizeof(Int));
+    if (!key || !stamp)
+    {
+        mongoose_free(key);
+        mongoose_free(stamp);
+        return -1;
+    }
+
+    for (Int k = 0; k < n; k++)
+    {
+        uint64_t h = 0;
+        for (Int p = Gp[k]; p < Gp[k + 1]; p++)
+            h += mixVertex(Gi[p]);
+        key[k].degree = Gp[k + 1] - Gp[k];
+        key[k].hash   = h;
+        key[k].vertex = k;
+        map[k]        = -1;
+    }
+    std::sort(key, key + n);
+
+    Int cn = 0;
+    for (Int start = 0; start < n;)
+    {
+        /* key[start..end-1] have the same degree and hash */
+        Int end = start + 1;
+        while (end < n && key[end].sameNeighborhood(key[start]))
+            end++;
+
+        for (Int a = start; a < end; a++)
+        {
+            Int v = key[a].vertex;
+            if (map[v] >= 0)
+                continue;
+
+            /* v leads a new super-vertex; stamp its neighbors with v+1 */
+            map[v]        = cn;
+            double weight = (Gw) ? Gw[v] : 1;
+            for (Int p = Gp[v]; p < Gp[v + 1]; p++)
+                stamp[Gi[p]] = v + 1;
+
+            for (Int b = a + 1; b < end; b++)
+            {
+                Int u = key[b].vertex;
+                if (map[u] >= 0)
+                    continue;
+
+                double uWeight = (Gw) ? Gw[u] : 1;
+                if (weight + uWeight > maxWeight)
+                    break;
+
+                bool twin = true;
+                for (Int p = Gp[u]; p < Gp[u + 1] && twin; p++)
+                    twin = (stamp[Gi[p]] == v + 1);
+                if (twin)
+                {
+                    map[u] = cn;
+                    weight += uWeight;
+                }
+            }
+            cn++;
+        }
+        start = end;
+    }
+
+    /* Renumber the super-vertices in order of their first vertex, reusing
+       stamp, to keep the locality of the graph */
+    for (Int c = 0; c < cn; c++)
+        stamp[c] = -1;
+    Int next = 0;
+    for (Int k = 0; k < n; k++)
+    {
+        if (stamp[map[k]] < 0)
+            stamp[map[k]] = next++;
+        map[k] = stamp[map[k]];
+    }
+
+    mongoose_free(key);
+    mongoose_free(stamp);
+
+    return cn;
+}
+
+/**
+ * @brief Build the graph in which each set of merged vertices is one vertex
+ *
+ * Vertex weights are summed, edges between merged vertices are dropped, and
+ * parallel edges are combined by summing their weights.
+ *
+ * @param graph Graph to be contracted
+ * @param map map[k] is the vertex of the contracted graph containing k
+ * @param cn The number of vertices of the contracted graph
+ * @return The contracted graph, with edge and vertex weights, or NULL if out
+ *         of memory.
+ */
+Graph *contractGraph(const Graph *graph, const Int *map, Int cn)
+{
+    Int n      = graph->n;
+    Int *Gp    = graph->p;
+    Int *Gi    = graph->i;
+    double *Gx = graph->x;
+    double *Gw = graph->w;
+
+    size_t size = static_cast<size_t>(cn);
+    Int *head   = (Int *)mongoose_calloc(size + 1, sizeof(Int));
+    Int *member = (Int *)mongoose_malloc(static_cast<size_t>(n), sizeof(Int));
+    Int *htable = (Int *)mongoose_malloc(size, sizeof(Int));
+    Graph *contracted
+        = (head && member && htable) ? Graph::create(cn, Gp[n]) : NULL;
+    if (contracted)
+    {
+        contracted->x = (double *)mongoose_malloc(
+            static_cast<size_t>(Gp[n]), sizeof(double));
+        contracted->w = (double *)mongoose_malloc(size, sizeof(double));
+        if (!contracted->x || !contracted->w)
+        {
+            contracted->~Graph();
+            contracted = NULL;
+        }
+    }
+    if (!contracted)
+    {
+        mongoose_free(head);
+        mongoose_free(member);
+        mongoose_free(htable);
+        return NULL;
+    }
+
+    /* List the members of each merged vertex by counting sort */
+    for (Int k = 0; k < n; k++)
+        head[map[k] + 1]++;
+    for (Int c = 0; c < cn; c++)
+        head[c + 1] += head[c];
+    for (Int k = 0; k < n; k++)
+        member[head[map[k]]++] = k;
+    for (Int c = cn; c > 0; c--)
+        head[c] = head[c - 1];
+    head[0] = 0;
+
+    for (Int c = 0; c < cn; c++)
+        htable[c] = -1;
+
+    Int *Cp    = contracted->p;
+    Int *Ci    = contracted->i;
+    double *Cx = contracted->x;
+    double *Cw = contracted->w;
+    Int nz     = 0;
+    for (Int c = 0; c < cn; c++)
+    {
+        Int ps        = Cp[c] = nz;
+        double weight = 0;
+        for (Int m = head[c]; m < head[c + 1]; m++)
+        {
+            Int v = member[m];
+            weight += (Gw) ? Gw[v] : 1;
+            for (Int p = Gp[v]; p < Gp[v + 1]; p++)
+            {
+                Int target = map[Gi[p]];
+                if (target == c)
+                    continue;
+
+                double edgeWeight = (Gx) ? Gx[p] : 1;
+                if (htable[target] < ps)
+                {
+                    htable[target] = nz;
+                    Ci[nz]         = target;
+                    Cx[nz]         = edgeWeight;
+                    nz++;
+                }
+                else
+                {
+                    Cx[htable[target]] += edgeWeight;
+                }
+            }
+        }
+        Cw[c] = weight;
+    }
+    Cp[cn]         = nz;
+    contracted->nz = nz;
+
+    mongoose_free(head);
+    mongoose_free(member);
+    mongoose_free(htable);
+
+    return contracted;
+}
+
+/**
+ * @brief Partition a graph after folding its leaves and merging its twins
+ *
+ * The reduced graph is partitioned with the remaining options, and its
+ * partition is expanded back to @p graph. The cut cost and balance are those
+ * of the reduced graph, since merged vertices are never separated, but the
+ * number of cut edges is counted on @p graph. To keep the reduced graph
+ * balanceable, no merged vertex weighs more than the average weight of a
+ * vertex of the coarsest graph (the total weight divided by coarsen_limit).
+ *
+ * @param graph Graph to be partitioned
+ * @param options Options, with graph_reduction set
+ * @return The edge cut of @p graph, or NULL if out of memory.
+ */
+EdgeCut *edgeCutReduced(const Graph *graph, const EdgeCut_Options *options)
+{
+    Int n      = graph->n;
+    double *Gw = graph->w;
+
+    double W = 0;
+    for (Int k = 0; k < n; k++)
+        W += (Gw) ? Gw[k] : 1;
+    double maxWeight = W / static_cast<double>(options->coarsen_limit);
+
+    size_t size     = static_cast<size_t>(n);
+    Int *map        = (Int *)mongoose_malloc(size, sizeof(Int));
+    Int *twins      = (Int *)mongoose_malloc(size, sizeof(Int));
+    bool *partition = (bool *)mongoose_malloc(size, sizeof(bool));
+    EdgeCut_Options *innerOptions = EdgeCut_Options::create();
+    bool ok = (map && twins && partition && innerOptions);
+
+    /* Fold the leaves */
+    const Graph *current = graph;
+    Graph *folded        = NULL;
+    Int cnLeaves         = (ok) ? foldLeaves(graph, maxWeight, map) : -1;
+    ok                   = (cnLeaves >= 0);
+    if (ok && cnLeaves < n)
+    {
+        folded  = contractGraph(graph, map, cnLeaves);
+        ok      = (folded != NULL);
+        current = folded;
+    }
+
+    /* Merge the twins of the folded graph */
+    Graph *reduced = NULL;
+    Int cnTwins    = (ok) ? mergeTwins(current, maxWeight, twins) : -1;
+    ok             = (cnTwins >= 0);
+    if (ok && cnTwins < cnLeaves)
+    {
+        reduced = contractGraph(current, twins, cnTwins);
+        ok      = (reduced != NULL);
+        current = reduced;
+    }
+
+    EdgeCut *result = NULL;
+    if (ok)
+    {
+        LogInfo("Graph reduction: " << n << " vertices, " << cnLeaves
+                                    << " after folding leaves, " << cnTwins
+                                    << " after merging twins\n");
+
+        *innerOptions                 = *options;
+        innerOptions->graph_reduction = false;
+        result                        = edgeCutWhole(current, innerOptions);
+    }
+
+    if (result)
+    {
+        for (Int k = 0; k < n; k++)
+            partition[k] = result->partition[twins[map[k]]];
+
+        /* Merging twins combines parallel edges, so count the cut edges of
+           the original graph */
+        Int *Gp     = graph->p;
+        Int *Gi     = graph->i;
+        Int cutSize = 0;
+        for (Int k = 0; k < n; k++)
+        {
+            for (Int p = Gp[k]; p < Gp[k + 1]; p++)
+                cutSize += (partition[k] != partition[Gi[p]]);
+        }
+        result->cut_size = cutSize / 2;
+
+        mongoose_free(result->partition);
+        result->partition = partition;
+        result->n         = n;
+        partition         = NULL;
+    }
+
+    if (reduced)
+        reduced->~Graph();
+    if (folded)
+        folded->~Graph();
+    if (innerOptions)
+        innerOptions->~EdgeCut_Options();
+    mongoose_free(map);
+    mongoose_free(twins);
+    mongoose_free(partition);
+
+    return result;
+}
+
+} // end namespace Mongoose
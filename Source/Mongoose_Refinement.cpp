@@ -20,9 +20,19 @@ namespace Mongoose
 
 EdgeCutProblem *refine(EdgeCutProblem *graph, const EdgeCut_Options *options)
 {
-    Logger::tic(RefinementTiming);
+    Logger::tic(RefinementTiming, graph->parent->n);
 
     EdgeCutProblem *P             = graph->parent;
+
+    /* The fine graph gets its partition arrays only now that the cut is
+     * projected onto it. On failure, the coarse graph is left to the
+     * caller. */
+    if (!P->allocateRefinementArrays())
+    {
+        Logger::toc(RefinementTiming);
+        return NULL;
+    }
+
     Int cn               = graph->n;
     bool *cPartition     = graph->partition;
     double *fGains       = P->vertexGains;
@@ -35,32 +45,21 @@ EdgeCutProblem *refine(EdgeCutProblem *graph, const EdgeCut_Options *options)
     P->W1        = graph->W1;
     P->imbalance = graph->imbalance;
 
+    P->gradprojIterations = graph->gradprojIterations;
+
     /* For each vertex in the coarse graph. */
     for (Int k = 0; k < cn; k++)
     {
-        /* Load up the inverse matching */
-        Int v[3] = { -1, -1, -1 };
-        v[0]     = P->invmatchmap[k];
-        v[1]     = P->getMatch(v[0]);
-        if (v[0] == v[1])
-        {
-            v[1] = -1;
-        }
-        else
-        {
-            v[2] = P->getMatch(v[1]);
-            if (v[0] == v[2])
-            {
-                v[2] = -1;
-            }
-        }
-        /* Transfer the partition choices to the fine level. */
-        bool cp = cPartition[k];
-        for (Int i = 0; i < 3 && v[i] != -1; i++)
+        /* Transfer the partition choices to the fine level, walking the
+         * cycle of fine vertices matched into k. */
+        bool cp    = cPartition[k];
+        Int first  = P->invmatchmap[k];
+        Int vertex = first;
+        do
         {
-            Int vertex           = v[i];
             P->partition[vertex] = cp;
-        }
+            vertex               = P->getMatch(vertex);
+        } while (vertex != first);
     }
     /* See if we can relax the boundary constraint and recompute gains for
      * vertices on the boundary.
@@ -78,28 +77,11 @@ EdgeCutProblem *refine(EdgeCutProblem *graph, const EdgeCut_Options *options)
             /* Get the coarse vertex from the heap. */
             Int k = heap[hpos];
 
-            /* Load up the inverse matching */
-            Int v[3] = { -1, -1, -1 };
-            v[0]     = P->invmatchmap[k];
-            v[1]     = P->getMatch(v[0]);
-            if (v[0] == v[1])
-            {
-                v[1] = -1;
-            }
-            else
+            /* Relax the boundary constraint for each fine vertex of k. */
+            Int first  = P->invmatchmap[k];
+            Int vertex = first;
+            do
             {
-                v[2] = P->getMatch(v[1]);
-                if (v[0] == v[2])
-                {
-                    v[2] = -1;
-                }
-            }
-
-            /* Relax the boundary constraint. */
-            for (Int i = 0; i < 3 && v[i] != -1; i++)
-            {
-                Int vertex = v[i];
-
                 double gain;
                 Int externalDegree;
                 calculateGain(P, options, vertex, &gain, &externalDegree);
@@ -111,7 +93,9 @@ EdgeCutProblem *refine(EdgeCutProblem *graph, const EdgeCut_Options *options)
                     fGains[vertex]          = gain;
                     bhInsert(P, vertex);
                 }
-            }
+
+                vertex = P->getMatch(vertex);
+            } while (vertex != first);
         }
     }
 
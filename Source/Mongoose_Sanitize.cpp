@@ -11,6 +11,7 @@
 
 #include "Mongoose_Sanitize.hpp"
 #include "Mongoose_Internal.hpp"
+#include "Mongoose_Logger.hpp"
 
 using namespace std;
 
@@ -20,6 +21,7 @@ namespace Mongoose
 cs *sanitizeMatrix(cs *compressed_A, bool symmetricTriangular,
                    bool makeEdgeWeightsBinary)
 {
+    Logger::tic(SanitizeTiming, compressed_A->n);
     cs *cleanMatrix;
     if (symmetricTriangular)
     {
@@ -30,6 +32,7 @@ cs *sanitizeMatrix(cs *compressed_A, bool symmetricTriangular,
         cs *A_transpose = cs_transpose(compressed_A, 1);
         if (!A_transpose)
         {
+            Logger::toc(SanitizeTiming);
             return NULL;
         }
         cleanMatrix = cs_add(compressed_A, A_transpose, 0.5, 0.5);
@@ -38,6 +41,7 @@ cs *sanitizeMatrix(cs *compressed_A, bool symmetricTriangular,
 
     if (!cleanMatrix)
     {
+        Logger::toc(SanitizeTiming);
         return NULL;
     }
 
@@ -48,12 +52,14 @@ cs *sanitizeMatrix(cs *compressed_A, bool symmetricTriangular,
 
     if (!cleanMatrix_transpose)
     {
+        Logger::toc(SanitizeTiming);
         return NULL;
     }
     cleanMatrix = cs_transpose(cleanMatrix_transpose, 1);
     cs_spfree(cleanMatrix_transpose);
     if (!cleanMatrix)
     {
+        Logger::toc(SanitizeTiming);
         return NULL;
     }
 
@@ -77,6 +83,7 @@ cs *sanitizeMatrix(cs *compressed_A, bool symmetricTriangular,
         }
     }
 
+    Logger::toc(SanitizeTiming);
     return cleanMatrix;
 }
 
@@ -0,0 +1,184 @@
+/* ========================================================================== */
+/* === Source/Mongoose_Trace.cpp ============================================ */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * Mongoose Graph Partitioning Library  Copyright (C) 2017-2018,
+ * Scott P. Kolodziej, Nuri S. Yeralan, Timothy A. Davis, William W. Hager
+ * Mongoose is licensed under Version 3 of the GNU General Public License.
+ * Mongoose is also available under other licenses; contact authors for details.
+ * -------------------------------------------------------------------------- */
+
+#include "Mongoose_Trace.hpp"
+#include "Mongoose_Logger.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+
+namespace Mongoose
+{
+
+/* A begin or end event of the timeline */
+struct TraceEvent
+{
+    const char *name;
+    double time; /* microseconds since the trace was started */
+    Int size;    /* size of the problem, or -1 if not known   */
+    Int level;   /* coarsening level                          */
+    int thread;  /* small number identifying the thread       */
+    bool begin;
+};
+
+std::atomic<bool> Trace::tracingOn(false);
+
+/* The events of all threads, in the order they were recorded */
+static std::mutex traceMutex;
+static TraceEvent *events = NULL;
+static size_t numEvents   = 0;
+static size_t maxEvents   = 0;
+static bool truncated     = false; /* set once the list could not grow */
+static std::chrono::steady_clock::time_point origin
+    = std::chrono::steady_clock::now();
+
+/* Threads are numbered in the order they first record an event */
+static std::atomic<int> numThreads(0);
+static thread_local int threadId = -1;
+
+static void record(const char *name, Int size, bool begin)
+{
+    if (threadId < 0)
+        threadId = numThreads++;
+
+    TraceEvent event;
+    event.name  = name;
+    event.time  = std::chrono::duration<double, std::micro>(
+                     std::chrono::steady_clock::now() - origin)
+                     .count();
+    event.size   = size;
+    event.level  = Logger::getTimingLevel();
+    event.thread = threadId;
+    event.begin  = begin;
+
+    std::lock_guard<std::mutex> lock(traceMutex);
+    if (truncated)
+        return;
+    if (numEvents == maxEvents)
+    {
+        /* Grow the list geometrically. If out of memory, stop recording
+           until the trace is cleared, so that the events kept still pair up
+           in the order they happened. */
+        size_t newMax = (maxEvents > 0) ? 2 * maxEvents : 4096;
+        int ok;
+        TraceEvent *grown = (TraceEvent *)mongoose_realloc(
+            newMax, maxEvents, sizeof(TraceEvent), events, &ok);
+        if (!ok)
+        {
+            truncated = true;
+            LogError("Error: Out of memory for the trace; stopped recording"
+                     " after " << numEvents << " events\n");
+            return;
+        }
+        events    = grown;
+        maxEvents = newMax;
+    }
+    events[numEvents++] = event;
+}
+
+/**
+ * Record the beginning of a phase on this thread.
+ *
+ * @param name Name of the phase; must be a string literal (it is not copied)
+ * @param size Size of the problem the phase works on, or -1 if not known
+ */
+void Trace::begin(const char *name, Int size)
+{
+    if (tracingOn)
+        record(name, size, true);
+}
+
+/* Record the end of the phase last begun on this thread */
+void Trace::end(const char *name)
+{
+    if (tracingOn)
+        record(name, -1, false);
+}
+
+void Trace::setTracingFlag(bool tFlag)
+{
+    tracingOn = tFlag;
+}
+
+/**
+ * Write the events recorded so far as a Chrome trace (JSON).
+ *
+ * @param filename File to write the trace to
+ * @return true if the trace was written, false otherwise
+ */
+bool Trace::write(const char *filename)
+{
+    FILE *file = fopen(filename, "w");
+    if (!file)
+    {
+        LogError("Error: Cannot write trace to " << filename << "\n");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(traceMutex);
+    bool ok = (fprintf(file, "{\"traceEvents\":[\n") > 0);
+    for (size_t e = 0; e < numEvents && ok; e++)
+    {
+        const TraceEvent &event = events[e];
+        ok = (fprintf(file,
+                      "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":0,"
+                      "\"tid\":%d,\"args\":{\"level\":%ld",
+                      event.name, (event.begin) ? 'B' : 'E', event.time,
+                      event.thread, (long)event.level)
+              > 0);
+        if (ok && event.size >= 0)
+            ok = (fprintf(file, ",\"n\":%ld", (long)event.size) > 0);
+        if (ok)
+            ok = (fprintf(file, "}}%s\n", (e + 1 < numEvents) ? "," : "") > 0);
+    }
+    ok = ok && (fprintf(file, "],\"displayTimeUnit\":\"ms\"}\n") > 0);
+    ok = (fclose(file) == 0) && ok;
+
+    if (!ok)
+        LogError("Error: Cannot write trace to " << filename << "\n");
+    return ok;
+}
+
+/* Discard the events recorded so far, and restart the clock of the trace */
+void Trace::clear()
+{
+    std::lock_guard<std::mutex> lock(traceMutex);
+    mongoose_free(events);
+    events    = NULL;
+    numEvents = 0;
+    maxEvents = 0;
+    truncated = false;
+    origin    = std::chrono::steady_clock::now();
+}
+
+void set_tracing(bool enabled)
+{
+    Trace::setTracingFlag(enabled);
+}
+
+bool write_trace(const std::string &filename)
+{
+    return Trace::write(filename.c_str());
+}
+
+bool write_trace(const char *filename)
+{
+    return Trace::write(filename);
+}
+
+void clear_trace()
+{
+    Trace::clear();
+}
+
+} // end namespace Mongoose
@@ -22,8 +22,11 @@ void waterdance(EdgeCutProblem *graph, const EdgeCut_Options *options)
     Int numDances = options->num_dances;
     for (Int i = 0; i < numDances; i++)
     {
+        graph->stats.cut_before_FM = graph->cutCost;
         improveCutUsingFM(graph, options);
+        graph->stats.cut_after_FM = graph->cutCost;
         improveCutUsingQP(graph, options);
+        graph->stats.cut_after_QP = graph->cutCost;
     }
 }
 
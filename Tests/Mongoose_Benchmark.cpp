@@ -0,0 +1,357 @@
+#include "Mongoose_Test.hpp"
+#include "Mongoose_BoundaryHeap.hpp"
+#include "Mongoose_Coarsening.hpp"
+#include "Mongoose_EdgeCutProblem.hpp"
+#include "Mongoose_Generators.hpp"
+#include "Mongoose_ImproveFM.hpp"
+#include "Mongoose_IO.hpp"
+#include "Mongoose_Matching.hpp"
+#include "Mongoose_QPGradProj.hpp"
+#include "Mongoose_QPLinks.hpp"
+#include "Mongoose_QPNapsack.hpp"
+#include "Mongoose_Random.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ostream>
+#include <vector>
+
+using namespace Mongoose;
+
+/* The state a kernel runs on. Everything is rebuilt by the setup of each
+   repetition, so every repetition of a kernel sees exactly the same input. */
+struct BenchmarkState
+{
+    const char *inputFile;
+    const Graph *graph;
+    EdgeCut_Options *options;
+    EdgeCutProblem *problem;
+    EdgeCutProblem *coarse;
+    QPDelta *QP;
+    Graph *readGraph;
+};
+
+struct BenchmarkKernel
+{
+    const char *name;
+    MatchingStrategy matchingStrategy;
+    bool (*setup)(BenchmarkState *);
+    void (*run)(BenchmarkState *);
+};
+
+/* === Setup ================================================================ */
+
+static bool setupNothing(BenchmarkState *s)
+{
+    (void)s; // Unused variable
+    return true;
+}
+
+/* A fresh problem for the input graph */
+static bool setupProblem(BenchmarkState *s)
+{
+    setRandomSeed(s->options->random_seed);
+    s->problem = EdgeCutProblem::create(s->graph);
+    if (!s->problem)
+        return false;
+    s->problem->initialize(s->options);
+    return true;
+}
+
+/* A fresh problem, matched and ready to coarsen */
+static bool setupMatched(BenchmarkState *s)
+{
+    if (!setupProblem(s))
+        return false;
+    match(s->problem, s->options);
+    return true;
+}
+
+/* A fresh problem split in natural order, as InitialEdgeCut_NaturalOrder */
+static bool setupPartition(BenchmarkState *s)
+{
+    if (!setupProblem(s) || !s->problem->allocateRefinementArrays())
+        return false;
+    for (Int k = 0; k < s->problem->n; k++)
+        s->problem->partition[k] = (k < s->problem->n / 2);
+    return true;
+}
+
+/* The natural order split, with its boundary heaps loaded */
+static bool setupBoundary(BenchmarkState *s)
+{
+    if (!setupPartition(s))
+        return false;
+    bhLoad(s->problem, s->options);
+    return true;
+}
+
+/* A napsack problem: the input graph's vertex weights, and a fixed
+   pseudo-random point (mostly outside [0,1]) to project */
+static bool setupNapsack(BenchmarkState *s)
+{
+    if (!setupProblem(s))
+        return false;
+    Int n = s->problem->n;
+    s->QP = QPDelta::Create(n);
+    if (!s->QP)
+        return false;
+
+    double W           = s->problem->W;
+    double tol         = s->options->soft_split_tolerance;
+    double targetSplit = s->options->target_split;
+    s->QP->lo          = W * std::max(0., targetSplit - tol);
+    s->QP->hi          = W * std::min(1., targetSplit + tol);
+    s->QP->lambda      = 0;
+    for (Int k = 0; k < n; k++)
+    {
+        double y = static_cast<double>(Mongoose::random() % 2001) / 1000.0 - 0.5;
+        s->QP->x[k]              = y;
+        s->QP->FreeSet_status[k] = (y >= 1.0) ? 1 : (y <= 0.0) ? -1 : 0;
+    }
+    return true;
+}
+
+/* The QP of the natural order split, set up as improveCutUsingQP does up to
+   QPLinks: the continuous guess, its free set, and a feasible starting point */
+static bool setupQP(BenchmarkState *s)
+{
+    if (!setupBoundary(s))
+        return false;
+    EdgeCutProblem *graph = s->problem;
+    Int n                 = graph->n;
+    s->QP                 = QPDelta::Create(n);
+    if (!s->QP)
+        return false;
+
+    QPDelta *QP        = s->QP;
+    double tol         = s->options->soft_split_tolerance;
+    double targetSplit = s->options->target_split;
+    QP->lo             = graph->W * std::max(0., targetSplit - tol);
+    QP->hi             = graph->W * std::min(1., targetSplit + tol);
+
+    double b = 0.0;
+    for (Int k = 0; k < n; k++)
+    {
+        if (graph->partition[k])
+            QP->x[k] = graph->BH_inBoundary(k) ? 0.75 : 1.0;
+        else
+            QP->x[k] = graph->BH_inBoundary(k) ? 0.25 : 0.0;
+
+        double maxWeight = 0;
+        for (Int p = graph->p[k]; p < graph->p[k + 1]; p++)
+            maxWeight = std::max(maxWeight, (graph->x) ? graph->x[p] : 1);
+        QP->D[k] = maxWeight;
+
+        QP->FreeSet_status[k]
+            = (QP->x[k] >= 1.0) ? 1 : (QP->x[k] <= 0.0) ? -1 : 0;
+        b += ((graph->w) ? graph->w[k] : 1) * QP->x[k];
+    }
+    QP->b = b;
+
+    if (QP->b < QP->lo || QP->b > QP->hi)
+    {
+        QP->lambda = QPNapsack(QP->x, n, QP->lo, QP->hi, graph->w, QP->lambda,
+                               QP->FreeSet_status, QP->wx[1], QP->wi[0],
+                               QP->wi[1], s->options->gradproj_tolerance,
+                               s->options->napsack_solver);
+    }
+    return true;
+}
+
+/* The QP above, linked and ready for gradient projection */
+static bool setupLinked(BenchmarkState *s)
+{
+    return setupQP(s) && QPLinks(s->problem, s->options, s->QP);
+}
+
+static void teardown(BenchmarkState *s)
+{
+    if (s->coarse)
+        s->coarse->~EdgeCutProblem();
+    if (s->problem)
+        s->problem->~EdgeCutProblem();
+    if (s->QP)
+    {
+        s->QP->~QPDelta();
+        mongoose_free(s->QP);
+    }
+    if (s->readGraph)
+        s->readGraph->~Graph();
+    s->coarse    = NULL;
+    s->problem   = NULL;
+    s->QP        = NULL;
+    s->readGraph = NULL;
+}
+
+/* === Kernels ============================================================== */
+
+static void runReadGraph(BenchmarkState *s)
+{
+    s->readGraph = read_graph(s->inputFile);
+}
+
+static void runMatch(BenchmarkState *s)
+{
+    match(s->problem, s->options);
+}
+
+static void runCoarsen(BenchmarkState *s)
+{
+    s->coarse = coarsen(s->problem, s->options);
+}
+
+static void runBhLoad(BenchmarkState *s)
+{
+    bhLoad(s->problem, s->options);
+}
+
+static void runFMRefine(BenchmarkState *s)
+{
+    fmRefine_worker(s->problem, s->options);
+}
+
+static void runQPNapsack(BenchmarkState *s)
+{
+    QPDelta *QP = s->QP;
+    QPNapsack(QP->x, s->problem->n, QP->lo, QP->hi, s->problem->w, QP->lambda,
+              QP->FreeSet_status, QP->wx[1], QP->wi[0], QP->wi[1],
+              s->options->gradproj_tolerance, s->options->napsack_solver);
+}
+
+static void runQPLinks(BenchmarkState *s)
+{
+    QPLinks(s->problem, s->options, s->QP);
+}
+
+static void runQPGradProj(BenchmarkState *s)
+{
+    QPGradProj(s->problem, s->options, s->QP);
+}
+
+static const BenchmarkKernel kernels[] = {
+    { "read_graph", HEMSR, setupNothing, runReadGraph },
+    { "match_Random", Random, setupProblem, runMatch },
+    { "match_HEM", HEM, setupProblem, runMatch },
+    { "match_HEMSR", HEMSR, setupProblem, runMatch },
+    { "match_HEMSRdeg", HEMSRdeg, setupProblem, runMatch },
+    { "match_LabelProp", LabelProp, setupProblem, runMatch },
+    { "coarsen", HEMSR, setupMatched, runCoarsen },
+    { "bhLoad", HEMSR, setupPartition, runBhLoad },
+    { "fmRefine_worker", HEMSR, setupBoundary, runFMRefine },
+    { "QPNapsack", HEMSR, setupNapsack, runQPNapsack },
+    { "QPLinks", HEMSR, setupQP, runQPLinks },
+    { "QPGradProj", HEMSR, setupLinked, runQPGradProj },
+};
+
+/* === Reporting ============================================================ */
+
+/* The nearest-rank percentile of sorted samples */
+static double percentile(const std::vector<double> &sorted, double p)
+{
+    size_t rank = static_cast<size_t>(
+        std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+    rank        = std::max<size_t>(1, std::min(rank, sorted.size()));
+    return sorted[rank - 1];
+}
+
+/**
+ * Time each kernel on the graph in the file input, or on the graph generated
+ * from the specification input (see generate_graph), and write the results
+ * as a JSON object to out. read_graph is only timed for files. Each kernel
+ * is run warmup times untimed, then repetitions times timed, on a freshly
+ * built input each time; the setup is not timed. Times are in seconds of
+ * wall clock time.
+ */
+int runBenchmark(const std::string &input, bool generate, int repetitions,
+                 int warmup, std::ostream &out)
+{
+    BenchmarkState state;
+    state.inputFile = (generate) ? NULL : input.c_str();
+    state.problem   = NULL;
+    state.coarse    = NULL;
+    state.QP        = NULL;
+    state.readGraph = NULL;
+    state.options   = EdgeCut_Options::create();
+    if (!state.options)
+    {
+        LogTest("Error creating Options struct in Benchmark\n");
+        return EXIT_FAILURE;
+    }
+
+    Graph *graph = (generate) ? generate_graph(input) : read_graph(input);
+    if (!graph)
+    {
+        LogTest("Error reading or generating Graph in Benchmark\n");
+        state.options->~EdgeCut_Options();
+        return EXIT_FAILURE;
+    }
+    state.graph = graph;
+
+    out << "    {" << std::endl;
+    out << "      \"" << ((generate) ? "Generator" : "InputFile") << "\": \""
+        << input << "\"," << std::endl;
+    out << "      \"n\": " << graph->n << "," << std::endl;
+    out << "      \"nz\": " << graph->nz << "," << std::endl;
+    out << "      \"Kernels\": [" << std::endl;
+
+    int status         = EXIT_SUCCESS;
+    const int nKernels = sizeof(kernels) / sizeof(kernels[0]);
+    bool first         = true;
+    std::vector<double> samples;
+    for (int kk = 0; kk < nKernels && status == EXIT_SUCCESS; kk++)
+    {
+        const BenchmarkKernel &kernel = kernels[kk];
+        if (kernel.run == runReadGraph && !state.inputFile)
+            continue;
+        state.options->matching_strategy = kernel.matchingStrategy;
+
+        samples.clear();
+        for (int r = 0; r < warmup + repetitions; r++)
+        {
+            if (!kernel.setup(&state))
+            {
+                LogTest("Error setting up " << kernel.name << " in Benchmark\n");
+                teardown(&state);
+                status = EXIT_FAILURE;
+                break;
+            }
+            std::chrono::steady_clock::time_point start
+                = std::chrono::steady_clock::now();
+            kernel.run(&state);
+            double t = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+            teardown(&state);
+            if (r >= warmup)
+                samples.push_back(t);
+        }
+        if (samples.empty())
+            continue;
+
+        std::sort(samples.begin(), samples.end());
+        double sum = 0;
+        for (size_t k = 0; k < samples.size(); k++)
+            sum += samples[k];
+
+        out << ((first) ? "" : ",\n") << "        { \"Name\": \""
+            << kernel.name << "\""
+            << ", \"Min\": " << samples.front()
+            << ", \"Median\": " << percentile(samples, 50)
+            << ", \"P90\": " << percentile(samples, 90)
+            << ", \"P99\": " << percentile(samples, 99)
+            << ", \"Max\": " << samples.back()
+            << ", \"Mean\": " << sum / static_cast<double>(samples.size())
+            << " }";
+        first = false;
+    }
+
+    out << std::endl << "      ]" << std::endl;
+    out << "    }";
+
+    state.options->~EdgeCut_Options();
+    graph->~Graph();
+
+    return status;
+}
@@ -0,0 +1,116 @@
+#include "Mongoose_Test.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace Mongoose;
+
+#undef LOG_ERROR
+#undef LOG_WARN
+#undef LOG_INFO
+#undef LOG_TEST
+#define LOG_ERROR 1
+#define LOG_WARN 1
+#define LOG_INFO 0
+#define LOG_TEST 1
+
+/* Fixed inputs used when no graph is given on the command line */
+static const char *defaultInputs[]
+    = { "../Matrix/bcspwr10.mtx", "../Matrix/dwt_992.mtx",
+        "../Matrix/jagmesh7.mtx", "../Matrix/Pd.mtx" };
+static const char *defaultGenerators[] = { "mesh2d:200", "rmat:14" };
+
+int main(int argn, const char **argv)
+{
+    SuiteSparse_start();
+
+    // Read in the options and the graphs to benchmark
+    int repetitions = 25;
+    int warmup      = 3;
+    std::string outputFile;
+    std::vector<std::string> inputs;
+    std::vector<bool> generated;
+    bool usageError = false;
+    for (int k = 1; k < argn && !usageError; k++)
+    {
+        if (strcmp(argv[k], "-r") == 0 && k + 1 < argn)
+            repetitions = atoi(argv[++k]);
+        else if (strcmp(argv[k], "-w") == 0 && k + 1 < argn)
+            warmup = atoi(argv[++k]);
+        else if (strcmp(argv[k], "-o") == 0 && k + 1 < argn)
+            outputFile = std::string(argv[++k]);
+        else if (strcmp(argv[k], "-g") == 0 && k + 1 < argn)
+        {
+            inputs.push_back(std::string(argv[++k]));
+            generated.push_back(true);
+        }
+        else if (argv[k][0] == '-')
+            usageError = true;
+        else
+        {
+            inputs.push_back(std::string(argv[k]));
+            generated.push_back(false);
+        }
+    }
+    if (usageError || repetitions < 1 || warmup < 0)
+    {
+        // Wrong arguments - return error
+        LogError("Usage: mongoose_benchmark [-r repetitions] [-w warmup] "
+                 "[-o results.json] [-g kind:size[:seed] ...] "
+                 "[input-file.mtx ...]");
+        SuiteSparse_finish();
+        return EXIT_FAILURE;
+    }
+    if (inputs.empty())
+    {
+        for (size_t k = 0; k < sizeof(defaultInputs) / sizeof(char *); k++)
+        {
+            inputs.push_back(std::string(defaultInputs[k]));
+            generated.push_back(false);
+        }
+        for (size_t k = 0; k < sizeof(defaultGenerators) / sizeof(char *); k++)
+        {
+            inputs.push_back(std::string(defaultGenerators[k]));
+            generated.push_back(true);
+        }
+    }
+
+    // Set Logger to report only Test and Error messages, with no timing
+    Logger::setDebugLevel(Test + Error);
+    Logger::setTimingFlag(false);
+
+    // Write the results to the output file, or to stdout
+    std::ofstream ofs;
+    if (!outputFile.empty())
+    {
+        ofs.open(outputFile.c_str(), std::ofstream::out);
+        if (!ofs)
+        {
+            LogError("Error opening " << outputFile);
+            SuiteSparse_finish();
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream &out = (outputFile.empty()) ? std::cout : ofs;
+
+    out << "{" << std::endl;
+    out << "  \"Repetitions\": " << repetitions << "," << std::endl;
+    out << "  \"Warmup\": " << warmup << "," << std::endl;
+    out << "  \"Inputs\": [" << std::endl;
+    int status = EXIT_SUCCESS;
+    for (size_t k = 0; k < inputs.size() && status == EXIT_SUCCESS; k++)
+    {
+        if (!outputFile.empty())
+            LogTest("Benchmarking " << inputs[k] << "\n");
+        status = runBenchmark(inputs[k], generated[k], repetitions, warmup, out);
+        out << ((k + 1 < inputs.size()) ? "," : "") << std::endl;
+    }
+    out << "  ]" << std::endl;
+    out << "}" << std::endl;
+
+    SuiteSparse_finish();
+
+    return status;
+}
@@ -13,13 +13,20 @@
 /* Memory Management */
 #include "SuiteSparse_config.h"
 
+#include <ostream>
 #include <string>
+#include <vector>
 
 int runIOTest(const std::string &inputFile, bool validGraph);
 int runMemoryTest(const std::string &inputFile);
 int runTimingTest(const std::string &inputFile);
 int runEdgeSeparatorTest(const std::string &inputFile, const double targetSplit);
 int runPerformanceTest(const std::string &inputFile, const std::string &outputFile);
+int runBenchmark(const std::string &input, bool generate, int repetitions,
+                 int warmup, std::ostream &out);
+int runRegressionTest(const std::vector<std::string> &inputs,
+                      const std::string &baselineFile, bool record,
+                      bool checkTime, int repetitions, double tolerance);
 
 // Currently unused
 int runReferenceTest(const std::string &inputFile);
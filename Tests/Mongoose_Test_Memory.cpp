@@ -69,7 +69,7 @@ int RunAllTests (const std::string &inputFile, EdgeCut_Options *options)
     int m = 0;
     int remainingMallocs;
 
-    MatchingStrategy matchingStrategies[4] = {Random, HEM, HEMSR, HEMSRdeg};
+    MatchingStrategy matchingStrategies[5] = {Random, HEM, HEMSR, HEMSRdeg, LabelProp};
     InitialEdgeCutType guessCutStrategies[3] = {InitialEdgeCut_QP, InitialEdgeCut_Random, InitialEdgeCut_NaturalOrder};
     Int coarsenLimit[3] = {64, 256, 1024};
 
@@ -77,7 +77,7 @@ int RunAllTests (const std::string &inputFile, EdgeCut_Options *options)
     {
         options->do_community_matching = static_cast<bool>(c);
 
-        for(int i = 0; i < 4; i++)
+        for(int i = 0; i < 5; i++)
         {
             options->matching_strategy = matchingStrategies[i];
 
@@ -0,0 +1,360 @@
+#include "Mongoose_Test.hpp"
+#include "Mongoose_EdgeCut.hpp"
+#include "Mongoose_Generators.hpp"
+#include "Mongoose_IO.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+using namespace Mongoose;
+
+/* Regressions are reported whatever the library's log levels */
+#undef LOG_TEST
+#define LOG_TEST 1
+
+/* The measurements of one graph, as stored in a baseline */
+struct RegressionResult
+{
+    std::string input;
+    double time;    /* median wall clock time of edge_cut, in seconds   */
+    double timeMAD; /* median absolute deviation of the times           */
+    double peakMemory; /* peak bytes allocated by edge_cut              */
+    double cutCost;
+};
+
+/* === Peak memory ========================================================== */
+
+/* Allocators that keep the size of each block in front of it, so that the
+   bytes in use, and their peak, can be tracked */
+static size_t bytesInUse  = 0;
+static size_t bytesPeak   = 0;
+static const size_t Header = 16;
+
+static void *trackedMalloc(size_t size)
+{
+    char *block = (char *)malloc(size + Header);
+    if (!block)
+        return NULL;
+    *(size_t *)block = size;
+    bytesInUse += size;
+    bytesPeak = std::max(bytesPeak, bytesInUse);
+    return block + Header;
+}
+
+static void *trackedCalloc(size_t count, size_t size)
+{
+    void *p = trackedMalloc(count * size);
+    if (p)
+        memset(p, 0, count * size);
+    return p;
+}
+
+static void trackedFree(void *p)
+{
+    if (!p)
+        return;
+    char *block = (char *)p - Header;
+    bytesInUse -= *(size_t *)block;
+    free(block);
+}
+
+static void *trackedRealloc(void *p, size_t size)
+{
+    if (!p)
+        return trackedMalloc(size);
+    char *block   = (char *)p - Header;
+    size_t old    = *(size_t *)block;
+    char *newBlock = (char *)realloc(block, size + Header);
+    if (!newBlock)
+        return NULL;
+    *(size_t *)newBlock = size;
+    bytesInUse          = bytesInUse - old + size;
+    bytesPeak           = std::max(bytesPeak, bytesInUse);
+    return newBlock + Header;
+}
+
+/* === Measurement ========================================================== */
+
+static bool isGeneratorSpec(const std::string &input)
+{
+    return input.find(':') != std::string::npos
+           && input.find('/') == std::string::npos;
+}
+
+static double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    size_t k = values.size() / 2;
+    return (values.size() % 2) ? values[k] : (values[k - 1] + values[k]) / 2;
+}
+
+/* Time edge_cut on one graph, repetitions times, and measure its peak memory
+   and cut cost. Returns false if the graph could not be read or cut. */
+static bool measure(const std::string &input, int repetitions,
+                    RegressionResult *result)
+{
+    Graph *graph = (isGeneratorSpec(input)) ? generate_graph(input)
+                                            : read_graph(input);
+    EdgeCut_Options *options = EdgeCut_Options::create();
+    if (!graph || !options)
+    {
+        LogTest("Error reading " << input << " in Regression Test\n");
+        if (graph)
+            graph->~Graph();
+        if (options)
+            options->~EdgeCut_Options();
+        return false;
+    }
+
+    result->input = input;
+    std::vector<double> times;
+    bool ok = true;
+    for (int r = 0; r <= repetitions && ok; r++)
+    {
+        // Track the memory of the first run, which is not timed
+        void *(*mallocFunc)(size_t)          = SuiteSparse_config.malloc_func;
+        void *(*callocFunc)(size_t, size_t)  = SuiteSparse_config.calloc_func;
+        void *(*reallocFunc)(void *, size_t) = SuiteSparse_config.realloc_func;
+        void (*freeFunc)(void *)             = SuiteSparse_config.free_func;
+        if (r == 0)
+        {
+            bytesInUse = bytesPeak          = 0;
+            SuiteSparse_config.malloc_func  = trackedMalloc;
+            SuiteSparse_config.calloc_func  = trackedCalloc;
+            SuiteSparse_config.realloc_func = trackedRealloc;
+            SuiteSparse_config.free_func    = trackedFree;
+        }
+
+        std::chrono::steady_clock::time_point start
+            = std::chrono::steady_clock::now();
+        EdgeCut *cut = edge_cut(graph, options);
+        double t     = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+        ok = (cut != NULL);
+        if (cut)
+        {
+            result->cutCost = cut->cut_cost;
+            cut->~EdgeCut();
+        }
+        if (r == 0)
+        {
+            SuiteSparse_config.malloc_func  = mallocFunc;
+            SuiteSparse_config.calloc_func  = callocFunc;
+            SuiteSparse_config.realloc_func = reallocFunc;
+            SuiteSparse_config.free_func    = freeFunc;
+            result->peakMemory              = static_cast<double>(bytesPeak);
+        }
+        else
+        {
+            times.push_back(t);
+        }
+    }
+
+    options->~EdgeCut_Options();
+    graph->~Graph();
+    if (!ok)
+    {
+        LogTest("Error computing edge cut of " << input
+                                               << " in Regression Test\n");
+        return false;
+    }
+
+    result->time = median(times);
+    std::vector<double> deviations;
+    for (size_t k = 0; k < times.size(); k++)
+        deviations.push_back(std::fabs(times[k] - result->time));
+    result->timeMAD = median(deviations);
+    return true;
+}
+
+/* === Baselines ============================================================ */
+
+static bool writeBaseline(const std::string &filename,
+                          const std::vector<RegressionResult> &results)
+{
+    std::ofstream ofs(filename.c_str(), std::ofstream::out);
+    if (!ofs)
+        return false;
+    ofs << std::setprecision(17);
+    ofs << "{" << std::endl;
+    ofs << "  \"Graphs\": [" << std::endl;
+    for (size_t k = 0; k < results.size(); k++)
+    {
+        const RegressionResult &r = results[k];
+        ofs << "    { \"Input\": \"" << r.input << "\", \"Time\": " << r.time
+            << ", \"TimeMAD\": " << r.timeMAD
+            << ", \"PeakMemory\": " << r.peakMemory
+            << ", \"CutCost\": " << r.cutCost << " }"
+            << ((k + 1 < results.size()) ? "," : "") << std::endl;
+    }
+    ofs << "  ]" << std::endl;
+    ofs << "}" << std::endl;
+    return ofs.good();
+}
+
+/* Find "key": in line, and read the string or number after it */
+static bool readField(const std::string &line, const char *key,
+                      std::string *text, double *number)
+{
+    std::string quoted = std::string("\"") + key + "\":";
+    size_t pos         = line.find(quoted);
+    if (pos == std::string::npos)
+        return false;
+    const char *s = line.c_str() + pos + quoted.size();
+    while (*s == ' ')
+        s++;
+    if (text)
+    {
+        const char *end = (*s == '"') ? strchr(s + 1, '"') : NULL;
+        if (!end)
+            return false;
+        *text = std::string(s + 1, end);
+        return true;
+    }
+    char *end;
+    *number = strtod(s, &end);
+    return (end != s);
+}
+
+/* Read a baseline written by writeBaseline: one graph per line */
+static bool readBaseline(const std::string &filename,
+                         std::vector<RegressionResult> *results)
+{
+    std::ifstream ifs(filename.c_str());
+    if (!ifs)
+        return false;
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+        RegressionResult r;
+        if (!readField(line, "Input", &r.input, NULL))
+            continue;
+        if (!readField(line, "Time", NULL, &r.time)
+            || !readField(line, "TimeMAD", NULL, &r.timeMAD)
+            || !readField(line, "PeakMemory", NULL, &r.peakMemory)
+            || !readField(line, "CutCost", NULL, &r.cutCost))
+        {
+            LogTest("Error: malformed baseline line: " << line << "\n");
+            return false;
+        }
+        results->push_back(r);
+    }
+    return !results->empty();
+}
+
+/* === Comparison =========================================================== */
+
+/* The time above which a run is a regression: the baseline time plus the
+   relative tolerance, widened by the spread of both measurements and a floor
+   below which timer noise dominates */
+static double timeLimit(const RegressionResult &baseline,
+                        const RegressionResult &current, double tolerance)
+{
+    return baseline.time * (1 + tolerance)
+           + 3 * (baseline.timeMAD + current.timeMAD) + 1e-3;
+}
+
+/* The cut cost above which a run is a regression: the baseline cut cost
+   plus a margin for rounding, which differs between compilers and flags
+   (the baseline cut of a graph may itself be rounding noise around zero) */
+static double cutLimit(const RegressionResult &baseline)
+{
+    return baseline.cutCost * (1 + 1e-6) + 1e-6;
+}
+
+/**
+ * Run edge_cut on the graphs of a baseline and compare the results to it.
+ *
+ * With record set, or if the baseline file does not exist yet, the graphs in
+ * inputs are measured and the baseline is written instead. Otherwise the
+ * graphs of the baseline are measured, and the test fails if any cut cost
+ * exceeds cutLimit, if any peak memory exceeds its baseline by more than
+ * 5%, or (with checkTime set) if any median time exceeds timeLimit. A graph
+ * that is too slow is measured once more, with twice the repetitions, before
+ * it is reported, so that a single noisy measurement does not fail the test.
+ */
+int runRegressionTest(const std::vector<std::string> &inputs,
+                      const std::string &baselineFile, bool record,
+                      bool checkTime, int repetitions, double tolerance)
+{
+    std::vector<RegressionResult> baseline;
+    if (!record && !readBaseline(baselineFile, &baseline))
+    {
+        std::ifstream exists(baselineFile.c_str());
+        if (exists)
+        {
+            LogTest("Error reading baseline " << baselineFile << "\n");
+            return EXIT_FAILURE;
+        }
+        LogTest("No baseline " << baselineFile << " yet; recording it\n");
+        record = true;
+    }
+
+    if (record)
+    {
+        std::vector<RegressionResult> results;
+        for (size_t k = 0; k < inputs.size(); k++)
+        {
+            RegressionResult r;
+            if (!measure(inputs[k], repetitions, &r))
+                return EXIT_FAILURE;
+            LogTest(" " << std::setw(28) << std::left << r.input << std::right
+                        << " time " << std::setw(10) << r.time << "s, peak "
+                        << std::setw(10) << static_cast<Int>(r.peakMemory)
+                        << " bytes, cut " << r.cutCost << "\n");
+            results.push_back(r);
+        }
+        if (!writeBaseline(baselineFile, results))
+        {
+            LogTest("Error writing baseline " << baselineFile << "\n");
+            return EXIT_FAILURE;
+        }
+        LogTest("Baseline written to " << baselineFile << "\n");
+        return EXIT_SUCCESS;
+    }
+
+    int failures = 0;
+    for (size_t k = 0; k < baseline.size(); k++)
+    {
+        const RegressionResult &base = baseline[k];
+        RegressionResult r;
+        if (!measure(base.input, repetitions, &r))
+            return EXIT_FAILURE;
+        if (checkTime && r.time > timeLimit(base, r, tolerance))
+        {
+            measure(base.input, 2 * repetitions, &r);
+        }
+
+        bool slow       = checkTime && r.time > timeLimit(base, r, tolerance);
+        bool worseCut   = r.cutCost > cutLimit(base);
+        bool moreMemory = r.peakMemory > base.peakMemory * 1.05;
+        failures += (slow || worseCut || moreMemory);
+
+        LogTest(" " << std::setw(28) << std::left << base.input << std::right
+                    << " time " << std::setw(10) << r.time << "s (baseline "
+                    << std::setw(10) << base.time << "s)"
+                    << ", peak " << std::setw(10)
+                    << static_cast<Int>(r.peakMemory) << " bytes ("
+                    << std::setw(10) << static_cast<Int>(base.peakMemory) << ")"
+                    << ", cut " << r.cutCost << " (" << base.cutCost << ")"
+                    << ((slow) ? " SLOWER" : "")
+                    << ((moreMemory) ? " MORE MEMORY" : "")
+                    << ((worseCut) ? " WORSE CUT" : "") << "\n");
+    }
+
+    if (failures > 0)
+    {
+        LogTest(failures << " of " << baseline.size()
+                         << " graphs regressed against " << baselineFile
+                         << "\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,78 @@
+#include "Mongoose_Test.hpp"
+
+#include <cstring>
+#include <vector>
+
+using namespace Mongoose;
+
+#undef LOG_ERROR
+#undef LOG_WARN
+#undef LOG_INFO
+#undef LOG_TEST
+#define LOG_ERROR 1
+#define LOG_WARN 1
+#define LOG_INFO 0
+#define LOG_TEST 1
+
+/* Graphs recorded when no graph is given on the command line: the inputs of
+   mongoose_benchmark */
+static const char *defaultInputs[]
+    = { "../Matrix/bcspwr10.mtx", "../Matrix/dwt_992.mtx",
+        "../Matrix/jagmesh7.mtx", "../Matrix/Pd.mtx",
+        "mesh2d:200",             "rmat:14" };
+
+int main(int argn, const char **argv)
+{
+    SuiteSparse_start();
+
+    // Read in the options and the graphs to record
+    std::string baselineFile = "regression_baseline.json";
+    int repetitions          = 7;
+    double tolerance         = 0.2;
+    bool record              = false;
+    bool checkTime           = true;
+    std::vector<std::string> inputs;
+    bool usageError = false;
+    for (int k = 1; k < argn && !usageError; k++)
+    {
+        if (strcmp(argv[k], "-b") == 0 && k + 1 < argn)
+            baselineFile = std::string(argv[++k]);
+        else if (strcmp(argv[k], "-r") == 0 && k + 1 < argn)
+            repetitions = atoi(argv[++k]);
+        else if (strcmp(argv[k], "-t") == 0 && k + 1 < argn)
+            tolerance = atof(argv[++k]);
+        else if (strcmp(argv[k], "--record") == 0)
+            record = true;
+        else if (strcmp(argv[k], "--no-time") == 0)
+            checkTime = false;
+        else if (argv[k][0] == '-')
+            usageError = true;
+        else
+            inputs.push_back(std::string(argv[k]));
+    }
+    if (usageError || repetitions < 1 || tolerance < 0)
+    {
+        // Wrong arguments - return error
+        LogError("Usage: mongoose_test_regression [-b baseline.json] "
+                 "[-r repetitions] [-t tolerance] [--record] [--no-time] "
+                 "[input-file.mtx | kind:size[:seed] ...]");
+        SuiteSparse_finish();
+        return EXIT_FAILURE;
+    }
+    if (inputs.empty())
+    {
+        for (size_t k = 0; k < sizeof(defaultInputs) / sizeof(char *); k++)
+            inputs.push_back(std::string(defaultInputs[k]));
+    }
+
+    // Set Logger to report only Test and Error messages, with no timing
+    Logger::setDebugLevel(Test + Error);
+    Logger::setTimingFlag(false);
+
+    int status = runRegressionTest(inputs, baselineFile, record, checkTime,
+                                   repetitions, tolerance);
+
+    SuiteSparse_finish();
+
+    return status;
+}
@@ -8,9 +8,46 @@
 #include "Mongoose_Internal.hpp"
 #include "Mongoose_IO.hpp"
 #include "Mongoose_EdgeCut.hpp"
+#include "Mongoose_Trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 
 using namespace Mongoose;
 
+/* Whether the cut and part weights of result match a recount of its
+   partition of G, and the partition is balanced to within the tolerance */
+bool matchesRecount(const Graph *G, const EdgeCut_Options *O,
+                    const EdgeCut *result)
+{
+    Int cutSize    = 0;
+    double cutCost = 0;
+    double W0 = 0, W1 = 0;
+    for (Int k = 0; k < G->n; k++)
+    {
+        double w = (G->w) ? G->w[k] : 1;
+        if (result->partition[k])
+            W1 += w;
+        else
+            W0 += w;
+        for (Int p = G->p[k]; p < G->p[k + 1]; p++)
+        {
+            if (result->partition[k] != result->partition[G->i[p]])
+            {
+                cutSize++;
+                cutCost += (G->x) ? G->x[p] : 1;
+            }
+        }
+    }
+    double imbalance = fabs(O->target_split - std::min(W0, W1) / (W0 + W1));
+    return (cutSize / 2 == result->cut_size
+            && fabs(cutCost / 2 - result->cut_cost) < 1e-9
+            && W0 == result->w0 && W1 == result->w1
+            && imbalance <= O->soft_split_tolerance + 1e-9);
+}
+
 int main(int argn, char** argv)
 {
     (void)argn; // Unused variable
@@ -39,12 +76,33 @@ int main(int argn, char** argv)
 
     O = EdgeCut_Options::create();
 
+    // Test with invalid memory_limit
+    O->memory_limit = -1;
+    result = edge_cut(G, O);
+    assert(result == NULL);
+    O->memory_limit = 0;
+
     // Test with invalid coarsen_limit
     O->coarsen_limit = 0;
     result = edge_cut(G, O);
     assert(result == NULL);
     O->coarsen_limit = 50;
 
+    // Test with invalid coarsen_min_shrink
+    O->coarsen_min_shrink = 1;
+    result = edge_cut(G, O);
+    assert(result == NULL);
+    O->coarsen_min_shrink = -0.1;
+    result = edge_cut(G, O);
+    assert(result == NULL);
+    O->coarsen_min_shrink = 0.05;
+
+    // Test with invalid coarsen_max_levels
+    O->coarsen_max_levels = -1;
+    result = edge_cut(G, O);
+    assert(result == NULL);
+    O->coarsen_max_levels = 64;
+
     // Test with invalid high_degree_threshold
     O->high_degree_threshold = -1;
     result = edge_cut(G, O);
@@ -86,6 +144,12 @@ int main(int argn, char** argv)
     assert(result == NULL);
     O->gradproj_iteration_limit = 50;
 
+    // Test with invalid QP_band_depth
+    O->QP_band_depth = -1;
+    result = edge_cut(G, O);
+    assert(result == NULL);
+    O->QP_band_depth = 0;
+
     // Test with invalid target_split
     O->target_split = 1.2;
     result = edge_cut(G, O);
@@ -125,6 +189,354 @@ int main(int argn, char** argv)
     result->~EdgeCut();
     O->coarsen_limit = 50;
 
+    // Test with BFS and RCM vertex orderings: the partition must be in the
+    // original numbering
+    O->coarsen_limit = 10;
+    for (int ordering = VertexOrdering_BFS; ordering <= VertexOrdering_RCM;
+         ordering++)
+    {
+        O->vertex_ordering = (VertexOrdering)ordering;
+        result             = edge_cut(G, O);
+        assert(result != NULL && result->n == G->n);
+        Int cutSize = 0;
+        for (Int k = 0; k < G->n; k++)
+        {
+            for (Int p = G->p[k]; p < G->p[k + 1]; p++)
+            {
+                if (result->partition[k] != result->partition[G->i[p]])
+                    cutSize++;
+            }
+        }
+        assert(cutSize / 2 == result->cut_size);
+        result->~EdgeCut();
+    }
+    O->vertex_ordering = VertexOrdering_Natural;
+
+    // Test with graph reduction: the partition must be expanded back exactly
+    O->graph_reduction = true;
+    result             = edge_cut(G, O);
+    assert(result != NULL && result->n == G->n);
+    Int cutSize = 0;
+    double w0   = 0;
+    for (Int k = 0; k < G->n; k++)
+    {
+        w0 += (result->partition[k]) ? 0 : 1;
+        for (Int p = G->p[k]; p < G->p[k + 1]; p++)
+        {
+            if (result->partition[k] != result->partition[G->i[p]])
+                cutSize++;
+        }
+    }
+    assert(cutSize / 2 == result->cut_size);
+    assert(cutSize / 2 == (Int)result->cut_cost);
+    assert(w0 == result->w0 && result->w0 + result->w1 == G->n);
+    result->~EdgeCut();
+    O->graph_reduction = false;
+    O->coarsen_limit   = 50;
+
+    // Test label propagation with community matching: the vertices left
+    // over join the clusters, so every fine vertex must still be reached
+    const char *clusterFiles[2]
+        = { "../Matrix/bcspwr10.mtx", "../Matrix/Pd.mtx" };
+    Int clusterLimits[2]     = { 64, 256 };
+    O->matching_strategy     = LabelProp;
+    O->do_community_matching = true;
+    for (int f = 0; f < 2; f++)
+    {
+        Graph *C = read_graph(clusterFiles[f]);
+        assert(C != NULL);
+        for (int l = 0; l < 2; l++)
+        {
+            O->coarsen_limit = clusterLimits[l];
+            result           = edge_cut(C, O);
+            assert(result != NULL && result->n == C->n);
+            assert(matchesRecount(C, O, result));
+            result->~EdgeCut();
+        }
+        C->~Graph();
+    }
+    O->matching_strategy     = HEMSR;
+    O->do_community_matching = false;
+    O->coarsen_limit         = 50;
+
+    // Test gradient projection with and without Barzilai-Borwein steps. Each
+    // dance at each level runs gradproj twice, and each run stops at
+    // gradproj_iteration_limit, which a limit of 2 makes binding.
+    const char *qpFiles[3] = { "../Matrix/jagmesh7.mtx",
+                               "../Matrix/dwt_992.mtx", "../Matrix/G51.mtx" };
+    Int qpLimits[2]        = { 50, 2 };
+    O->collect_statistics  = true;
+    O->coarsen_limit       = 64;
+    for (int f = 0; f < 3; f++)
+    {
+        Graph *C = read_graph(qpFiles[f]);
+        assert(C != NULL);
+        for (int accelerate = 0; accelerate < 2; accelerate++)
+        {
+            for (int l = 0; l < 2; l++)
+            {
+                O->gradproj_accelerate      = static_cast<bool>(accelerate);
+                O->gradproj_iteration_limit = qpLimits[l];
+                result                      = edge_cut(C, O);
+                assert(result != NULL && result->n == C->n);
+                assert(matchesRecount(C, O, result));
+                assert(result->gradproj_iterations > 0);
+                Int runLimit   = 2 * O->num_dances * qpLimits[l];
+                Int iterations = 0;
+                for (Int k = 0; k < result->num_levels; k++)
+                {
+                    Int levelIterations = result->levels[k].QP_iterations;
+                    (void)levelIterations; // Unused if asserts are disabled
+                    assert(levelIterations >= 0);
+                    assert(levelIterations <= runLimit);
+                    iterations += levelIterations;
+                }
+                (void)runLimit;   // Unused variable if asserts are disabled
+                (void)iterations; // Unused variable if asserts are disabled
+                assert(iterations == result->gradproj_iterations);
+                result->~EdgeCut();
+            }
+        }
+        C->~Graph();
+    }
+    O->gradproj_accelerate      = false;
+    O->gradproj_iteration_limit = 50;
+    O->collect_statistics       = false;
+    O->coarsen_limit            = 50;
+
+    // Test QP restricted to a band of vertices around the cut: the vertices
+    // outside the band stay put, but the whole partition must stay balanced
+    O->coarsen_limit = 64;
+    for (int f = 0; f < 3; f++)
+    {
+        Graph *C = read_graph(qpFiles[f]);
+        assert(C != NULL);
+        for (Int depth = 1; depth <= 3; depth++)
+        {
+            O->QP_band_depth = depth;
+            result           = edge_cut(C, O);
+            assert(result != NULL && result->n == C->n);
+            assert(matchesRecount(C, O, result));
+            result->~EdgeCut();
+        }
+        C->~Graph();
+    }
+    O->QP_band_depth = 0;
+    O->coarsen_limit = 50;
+
+    // Test with a single coarsening level
+    O->coarsen_limit      = 2;
+    O->coarsen_max_levels = 1;
+    result                = edge_cut(G, O);
+    assert(result != NULL && result->partition != NULL);
+    result->~EdgeCut();
+    O->coarsen_max_levels = 64;
+
+    // Test per-level statistics
+    O->collect_statistics = true;
+    O->coarsen_limit      = 10;
+    result                = edge_cut(G, O);
+    assert(result != NULL && result->levels != NULL);
+    assert(result->num_levels > 1 && result->levels[0].n == G->n);
+    assert(result->levels[0].cut_after_QP == result->cut_cost);
+    for (Int l = 0; l + 1 < result->num_levels; l++)
+    {
+        EdgeCut_Level *level = &result->levels[l];
+        (void)level; // Unused variable if asserts are disabled
+        assert(level->orphan_matches + level->standard_matches
+                   + level->brotherly_matches + level->community_matches
+               == level->n);
+        assert(result->levels[l + 1].n < level->n);
+    }
+    assert(result->peak_memory > 0);
+    for (Int l = 0; l < result->num_levels; l++)
+    {
+        assert(result->levels[l].peak_memory > 0);
+        assert(result->levels[l].peak_memory <= result->peak_memory);
+    }
+    assert(!MemoryAccounting::isOn());
+    result->~EdgeCut();
+    O->collect_statistics = false;
+    O->coarsen_limit      = 50;
+
+    // Test tracing: every phase begun must have ended
+    Trace::clear();
+    Trace::setTracingFlag(true);
+    result = edge_cut(G, O);
+    assert(result != NULL);
+    result->~EdgeCut();
+    Trace::setTracingFlag(false);
+    bool written = Trace::write("trace_test.json");
+    (void)written; // Unused variable if asserts are disabled
+    assert(written);
+    FILE *traceFile = fopen("trace_test.json", "r");
+    assert(traceFile != NULL);
+    if (!traceFile)
+        return EXIT_FAILURE;
+    Int depth = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), traceFile))
+    {
+        if (strstr(line, "\"ph\":\"B\""))
+            depth++;
+        if (strstr(line, "\"ph\":\"E\""))
+            depth--;
+        assert(depth >= 0);
+    }
+    assert(depth == 0);
+    fclose(traceFile);
+    remove("trace_test.json");
+    Trace::clear();
+    written = Trace::write("no_such_directory/trace_test.json");
+    assert(!written);
+
+    // Test timing per coarsening level
+    Logger::setTimingFlag(true);
+    Logger::resetTiming();
+    O->coarsen_limit = 10;
+    result           = edge_cut(G, O);
+    assert(result != NULL);
+    result->~EdgeCut();
+    assert(Logger::getTimingLevels() > 1);
+    double levelSum = 0;
+    for (Int l = 0; l < Logger::getTimingLevels(); l++)
+        levelSum += Logger::getTime(MatchingTiming, l);
+    assert(std::fabs(levelSum - Logger::getTime(MatchingTiming)) < 1e-9);
+    Logger::resetTiming();
+    assert(Logger::getTimingLevels() == 1);
+    assert(Logger::getTime(MatchingTiming) == 0);
+    Logger::setTimingFlag(false);
+    O->coarsen_limit = 50;
+
+    // Test hardware counters: each is either unavailable or counted
+    bool counting = set_perf_counters(true);
+    (void)counting; // Unused variable if asserts are disabled
+    result        = edge_cut(G, O);
+    assert(result != NULL);
+    result->~EdgeCut();
+    for (int c = 0; c < PerfCounters::NumCounters; c++)
+    {
+        double count = get_perf_counter(MatchingTiming, (PerfCounterType)c);
+        (void)count; // Unused variable if asserts are disabled
+        assert(count == -1 || count >= 0);
+        assert(count == -1 || counting);
+    }
+    reset_timing();
+    set_perf_counters(false);
+
+    // Test memory accounting
+    void *before = mongoose_malloc(500, 1);
+    set_memory_accounting(true);
+    int ok      = 1;
+    void *block = mongoose_malloc(1000, 1);
+    assert(get_memory_in_use() == 1000);
+    block = mongoose_realloc(2000, 1000, 1, block, &ok);
+    assert(ok && get_memory_in_use() == 2000);
+    mongoose_free(before);
+    assert(get_memory_in_use() == 2000);
+    mongoose_free(block);
+    assert(get_memory_in_use() == 0 && get_memory_peak() >= 2000);
+    O->coarsen_limit = 10;
+    result           = edge_cut(G, O);
+    assert(result != NULL && result->peak_memory > 0);
+    assert(get_memory_in_use() > 0);
+    result->~EdgeCut();
+    assert(get_memory_in_use() == 0);
+    assert(get_memory_peak(CoarseningTiming) > 0);
+    assert(get_memory_allocated(CoarseningTiming) > 0);
+    assert(get_memory_peak(CoarseningTiming, 0) > 0);
+    reset_timing();
+    assert(get_memory_peak(CoarseningTiming) == 0);
+    set_memory_accounting(false);
+    result = edge_cut(G, O);
+    assert(result != NULL && result->peak_memory == -1);
+    result->~EdgeCut();
+    O->coarsen_limit = 50;
+
+    // Test with a memory limit
+    O->coarsen_limit      = 10;
+    O->collect_statistics = true;
+    EdgeCut *unlimited    = edge_cut(G, O);
+    assert(unlimited != NULL && unlimited->num_levels > 1);
+    O->memory_limit = 1e9;
+    result          = edge_cut(G, O);
+    assert(result != NULL && result->cut_cost == unlimited->cut_cost);
+    assert(result->num_levels == unlimited->num_levels);
+    assert(result->peak_memory <= unlimited->peak_memory);
+    result->~EdgeCut();
+
+    // Too little memory for the graph itself
+    O->memory_limit = 100;
+    result          = edge_cut(G, O);
+    assert(result == NULL);
+
+    // Tighter limits give up coarse levels or the QP, but not the limit
+    Int numFits = 0;
+    for (int k = 9; k >= 1; k--)
+    {
+        O->memory_limit = 0.1 * k * static_cast<double>(unlimited->peak_memory);
+        result          = edge_cut(G, O);
+        if (result)
+        {
+            assert(result->peak_memory <= O->memory_limit);
+            assert(result->w0 + result->w1 == G->n);
+            result->~EdgeCut();
+            numFits++;
+        }
+    }
+    assert(numFits >= 5);
+    (void)numFits; // Unused variable if asserts are disabled
+    unlimited->~EdgeCut();
+    O->memory_limit       = 0;
+    O->collect_statistics = false;
+    O->coarsen_limit      = 50;
+
+    O->~EdgeCut_Options();
+    G->~Graph();
+
+    // Component analysis: a path of 200 vertices and 20 disjoint edges
+    Int n = 240;
+    G = Graph::create(n, 2 * 199 + 2 * 20);
+    Int nz = 0;
+    for (Int k = 0; k < n; k++)
+    {
+        G->p[k] = nz;
+        if (k < 200)
+        {
+            if (k > 0)
+                G->i[nz++] = k - 1;
+            if (k < 199)
+                G->i[nz++] = k + 1;
+        }
+        else
+        {
+            G->i[nz++] = (k % 2 == 0) ? k + 1 : k - 1;
+        }
+    }
+    G->p[n] = nz;
+    O = EdgeCut_Options::create();
+    O->component_analysis = true;
+    result = edge_cut(G, O);
+    assert(result != NULL && result->n == n);
+    assert(result->w0 + result->w1 == n);
+    for (Int k = 200; k < n; k += 2)
+    {
+        // Small components are never cut
+        assert(result->partition[k] == result->partition[k + 1]);
+    }
+    result->~EdgeCut();
+
+    // Only small components: no cut at all
+    G->n = 40;
+    for (Int k = 0; k <= 40; k++)
+    {
+        G->p[k] = k;
+        G->i[k] = (k % 2 == 0) ? k + 1 : k - 1;
+    }
+    result = edge_cut(G, O);
+    assert(result != NULL && result->cut_size == 0);
+    assert(result->w0 == 20 && result->w1 == 20);
+    result->~EdgeCut();
     O->~EdgeCut_Options();
     G->~Graph();
 
@@ -8,9 +8,51 @@
 #include "Mongoose_Internal.hpp"
 #include "Mongoose_IO.hpp"
 #include "Mongoose_EdgeCutProblem.hpp"
+#include "Mongoose_EdgeCut.hpp"
+#include "Mongoose_Generators.hpp"
 
 using namespace Mongoose;
 
+/* Whether G is symmetric, with no self-edges or duplicate edges */
+bool isSimpleGraph(const Graph *G)
+{
+    for (Int k = 0; k < G->n; k++)
+    {
+        for (Int p = G->p[k]; p < G->p[k + 1]; p++)
+        {
+            Int j = G->i[p];
+            if (j == k || j < 0 || j >= G->n)
+                return false;
+            Int copies = 0, reverse = 0;
+            for (Int q = G->p[k]; q < G->p[k + 1]; q++)
+                copies += (G->i[q] == j);
+            for (Int q = G->p[j]; q < G->p[j + 1]; q++)
+                reverse += (G->i[q] == k);
+            if (copies != 1 || reverse != 1)
+                return false;
+        }
+    }
+    return true;
+}
+
+/* Whether A and B are the same graph, entry for entry */
+bool sameGraph(const Graph *A, const Graph *B)
+{
+    if (A->n != B->n || A->nz != B->nz)
+        return false;
+    for (Int k = 0; k <= A->n; k++)
+    {
+        if (A->p[k] != B->p[k])
+            return false;
+    }
+    for (Int p = 0; p < A->nz; p++)
+    {
+        if (A->i[p] != B->i[p])
+            return false;
+    }
+    return true;
+}
+
 /* Custom memory management functions allow for memory testing. */
 int AllowedMallocs;
 
@@ -54,6 +96,9 @@ int main(int argn, char** argv)
     // Test Graph(n, nz) static constructor
     Graph *G2 = Graph::create(10, 20);
     EdgeCutProblem *prob = EdgeCutProblem::create(G2);
+    assert(prob != NULL && !prob->hasRefinementArrays());
+    bool allocated = prob->allocateRefinementArrays();
+    assert(allocated && prob->hasRefinementArrays());
 
     prob->clearMarkArray(LONG_MAX);
     Int markValue = prob->getMarkValue();
@@ -65,6 +110,14 @@ int main(int argn, char** argv)
     assert(markValue >= 1);
     prob->~EdgeCutProblem();
 
+    // Arrays the caller stores in place of those Graph::create allocated
+    // are freed with the graph, so they must come from mongoose_malloc
+    mongoose_free(G2->i);
+    G2->i = (Int *)mongoose_malloc(20, sizeof(Int));
+    G2->w = (double *)mongoose_malloc(10, sizeof(double));
+    assert(G2->i != NULL && G2->w != NULL);
+    G2->~Graph();
+
     MM_typecode matcode;
     cs *M4 = read_matrix("../Matrix/bcspwr01.mtx", matcode);
     M4->x = NULL;
@@ -87,16 +140,78 @@ int main(int argn, char** argv)
     EdgeCutProblem *G4 = EdgeCutProblem::create(G7);
     assert(G4 == NULL);
 
-    AllowedMallocs = 5;
+    AllowedMallocs = 3;
     EdgeCutProblem *G5 = EdgeCutProblem::create(G7);
     assert(G5 == NULL);
 
-    AllowedMallocs = 10;
+    // Simulate failure to allocate the partition arrays
+    AllowedMallocs = 8;
     EdgeCutProblem *G6 = EdgeCutProblem::create(G7);
-    assert(G6 == NULL);
+    assert(G6 != NULL);
+    allocated = G6->allocateRefinementArrays();
+    assert(!allocated && !G6->hasRefinementArrays());
+    (void)allocated; // Unused variable if asserts are disabled
+    G6->~EdgeCutProblem();
 
     G7->~Graph();
 
+    // Restore the memory management functions
+    SuiteSparse_config.malloc_func  = malloc;
+    SuiteSparse_config.calloc_func  = calloc;
+    SuiteSparse_config.realloc_func = realloc;
+    SuiteSparse_config.free_func    = free;
+
+    // Test the structured generators against their known sizes
+    Graph *grid = generate_grid(4, 3);
+    assert(grid != NULL && grid->n == 12 && grid->nz == 2 * 17);
+    assert(isSimpleGraph(grid));
+    grid->~Graph();
+    grid = generate_grid(3, 3, 3);
+    assert(grid != NULL && grid->n == 27 && grid->nz == 2 * 54);
+    assert(isSimpleGraph(grid));
+    grid->~Graph();
+    grid = generate_mesh(3, 3);
+    assert(grid != NULL && grid->n == 9 && grid->nz == 2 * 20);
+    assert(isSimpleGraph(grid));
+    grid->~Graph();
+    grid = generate_mesh(2, 2, 2);
+    assert(grid != NULL && grid->n == 8 && grid->nz == 8 * 7);
+    grid->~Graph();
+    assert(generate_grid(0, 3) == NULL);
+
+    // Test the random generators: simple graphs, reproducible from the seed
+    const char *specs[] = { "geometric:500", "er:500", "rmat:9" };
+    for (int s = 0; s < 3; s++)
+    {
+        Graph *A = generate_graph(specs[s]);
+        Graph *B = generate_graph(std::string(specs[s]) + ":1");
+        Graph *C = generate_graph(std::string(specs[s]) + ":2");
+        assert(A != NULL && B != NULL && C != NULL);
+        assert(A->n == 500 || A->n == 512);
+        assert(A->nz > 2 * A->n);
+        assert(isSimpleGraph(A) && isSimpleGraph(C));
+        assert(sameGraph(A, B) && !sameGraph(A, C));
+        A->~Graph();
+        B->~Graph();
+        C->~Graph();
+    }
+
+    // Test invalid specifications
+    assert(generate_graph("grid2d") == NULL);
+    assert(generate_graph("grid2d:") == NULL);
+    assert(generate_graph("grid2d:10:") == NULL);
+    assert(generate_graph("grid2d:10x") == NULL);
+    assert(generate_graph("torus:10") == NULL);
+    assert(generate_graph("rmat:-1") == NULL);
+
+    // A generated graph can be partitioned
+    Graph *mesh = generate_graph("mesh3d:12");
+    assert(mesh != NULL && mesh->n == 12 * 12 * 12);
+    EdgeCut *cut = edge_cut(mesh);
+    assert(cut != NULL && cut->w0 + cut->w1 == mesh->n);
+    cut->~EdgeCut();
+    mesh->~Graph();
+
     SuiteSparse_finish();
 
     return 0;
@@ -1,6 +1,13 @@
 #include "Mongoose_Test.hpp"
 #include "Mongoose_IO.hpp"
 #include "Mongoose_Sanitize.hpp"
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace Mongoose;
 
@@ -57,7 +64,176 @@ int main(int argn, char** argv)
     {
         assert(binaryM->x[j] == 0 || binaryM->x[j] == 1);
     }
-    SuiteSparse_free(M);
+    cs_spfree(binaryM);
+    cs_spfree(M);
+
+    // Binary graph round trip
+    Graph *text = read_graph("../Matrix/bcspwr01.mtx");
+    assert(text != NULL);
+    bool written = write_graph_binary(text, "bcspwr01.mgb");
+    assert(written);
+    Graph *binary = read_graph_binary("bcspwr01.mgb");
+    assert(binary != NULL);
+    assert(binary->n == text->n && binary->nz == text->nz);
+    for (Int k = 0; k <= text->n; k++)
+    {
+        assert(binary->p[k] == text->p[k]);
+    }
+    for (Int k = 0; k < text->nz; k++)
+    {
+        assert(binary->i[k] == text->i[k]);
+        assert(binary->x[k] == text->x[k]);
+    }
+    binary->~Graph();
+
+    // read_graph recognizes binary graph files
+    binary = read_graph("bcspwr01.mgb");
+    assert(binary != NULL && binary->nz == text->nz);
+    binary->~Graph();
+    text->~Graph();
+
+    // Truncated binary graph file
+    FILE *file = fopen("truncated.mgb", "wb");
+    fwrite(BINARY_GRAPH_MAGIC, 1, 8, file);
+    fclose(file);
+    G = read_graph_binary("truncated.mgb");
+    assert(G == NULL);
+    remove("truncated.mgb");
+
+    // Binary graph files with column pointers or row indices out of order
+    // or out of range are rejected
+    file = fopen("bcspwr01.mgb", "rb");
+    assert(file != NULL);
+    std::vector<char> bytes;
+    char chunk[4096];
+    size_t count;
+    while (file && (count = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        bytes.insert(bytes.end(), chunk, chunk + count);
+    if (file)
+        fclose(file);
+    BinaryGraphHeader header;
+    memcpy(&header, &bytes[0], sizeof(BinaryGraphHeader));
+    for (int corruption = 0; corruption < 3; corruption++)
+    {
+        std::vector<char> corrupt = bytes;
+        Int *p = (Int *)&corrupt[header.offsetP];
+        Int *i = (Int *)&corrupt[header.offsetI];
+        if (corruption == 0)
+            p[1] = p[2] + 1;
+        else if (corruption == 1)
+            i[header.nz - 1] = header.n;
+        else
+            i[0] = -1;
+        file = fopen("corrupt.mgb", "wb");
+        fwrite(&corrupt[0], 1, corrupt.size(), file);
+        fclose(file);
+        G = read_graph_binary("corrupt.mgb");
+        assert(G == NULL);
+    }
+    remove("corrupt.mgb");
+    remove("bcspwr01.mgb");
+    (void)written;
+
+    // Streaming reader gives the same graph as read_graph
+    text   = read_graph("../Matrix/bcspwr01.mtx");
+    binary = read_graph_streaming("../Matrix/bcspwr01.mtx");
+    assert(text != NULL && binary != NULL);
+    assert(binary->n == text->n && binary->nz == text->nz);
+    for (Int k = 0; k < text->nz; k++)
+    {
+        assert(binary->i[k] == text->i[k]);
+    }
+    binary->~Graph();
+    text->~Graph();
+
+    // Unsymmetric entries, duplicates and a diagonal
+    file = fopen("stream_test.mtx", "w");
+    fprintf(file, "%%%%MatrixMarket matrix coordinate real general\n"
+                  "3 3 5\n1 2 4\n2 1 2\n3 3 1\n3 1 -2\n3 1 -2\n");
+    fclose(file);
+    G = read_graph_streaming("stream_test.mtx");
+    assert(G != NULL && G->nz == 4 && G->x != NULL);
+    assert(G->i[0] == 1 && G->x[0] == 3 && G->i[1] == 2 && G->x[1] == 2);
+    G->~Graph();
+
+    // Fewer entries than declared
+    file = fopen("stream_test.mtx", "w");
+    fprintf(file, "%%%%MatrixMarket matrix coordinate pattern general\n"
+                  "3 3 3\n1 2\n");
+    fclose(file);
+    G = read_graph_streaming("stream_test.mtx");
+    assert(G == NULL);
+    remove("stream_test.mtx");
+
+    // Graph cache: built on first use, reused, and rebuilt when stale
+    file = fopen("cache_test.mtx", "w");
+    fprintf(file, "%%%%MatrixMarket matrix coordinate pattern symmetric\n"
+                  "3 3 2\n2 1\n3 2\n");
+    fclose(file);
+    G = read_graph("cache_test.mtx", true);
+    assert(G != NULL && G->nz == 4);
+    G->~Graph();
+    assert(isBinaryGraphFile("cache_test.mtx.mgb"));
+    G = read_graph("cache_test.mtx", true);
+    assert(G != NULL && G->nz == 4);
+    G->~Graph();
+    file = fopen("cache_test.mtx", "w");
+    fprintf(file, "%%%%MatrixMarket matrix coordinate pattern symmetric\n"
+                  "3 3 3\n2 1\n3 2\n3 1\n");
+    fclose(file);
+    G = read_graph("cache_test.mtx", true);
+    assert(G != NULL && G->nz == 6);
+    G->~Graph();
+    G = read_graph_binary("cache_test.mtx.mgb");
+    assert(G != NULL && G->nz == 6);
+    G->~Graph();
+    remove("cache_test.mtx.mgb");
+#if defined(__unix__) || defined(__APPLE__)
+    // A cache that cannot be written leaves no temporary file behind
+    mkdir("cache_test.mtx.mgb", 0700);
+    G = read_graph("cache_test.mtx", true);
+    assert(G != NULL && G->nz == 6);
+    G->~Graph();
+    rmdir("cache_test.mtx.mgb");
+    Int leftover = 0;
+    DIR *dir     = opendir(".");
+    assert(dir != NULL);
+    struct dirent *entry;
+    while (dir && (entry = readdir(dir)) != NULL)
+        leftover += (strncmp(entry->d_name, "cache_test.mtx.mgb.", 19) == 0);
+    if (dir)
+        closedir(dir);
+    (void)leftover; // Unused variable if asserts are disabled
+    assert(leftover == 0);
+#endif
+    remove("cache_test.mtx");
+
+    // METIS graph with vertex and edge weights: a triangle
+    file = fopen("metis_test.graph", "w");
+    fprintf(file, "%% triangle\n3 3 011\n2 2 5 3 7\n"
+                  "4 1 5 3 6\n6 1 7 2 6\n");
+    fclose(file);
+    G = read_graph("metis_test.graph");
+    assert(G != NULL && G->n == 3 && G->nz == 6);
+    assert(G->w != NULL && G->w[0] == 2 && G->w[1] == 4 && G->w[2] == 6);
+    assert(G->x != NULL && G->i[0] == 1 && G->x[0] == 5);
+    G->~Graph();
+
+    // Self-edges are removed by sanitizing
+    file = fopen("metis_test.graph", "w");
+    fprintf(file, "3 2\n1 2\n1 3\n2\n");
+    fclose(file);
+    G = read_graph_metis("metis_test.graph");
+    assert(G != NULL && G->n == 3 && G->nz == 4 && G->w == NULL);
+    G->~Graph();
+
+    // Neighbor out of range
+    file = fopen("metis_test.graph", "w");
+    fprintf(file, "2 1\n2\n3\n");
+    fclose(file);
+    G = read_graph_metis("metis_test.graph");
+    assert(G == NULL);
+    remove("metis_test.graph");
 
     SuiteSparse_finish();
 
@@ -0,0 +1,243 @@
+
+#define LOG_ERROR 1
+#define LOG_WARN 1
+#define LOG_INFO 0
+#define LOG_TEST 1
+
+#include "Mongoose_Test.hpp"
+#include "Mongoose_Internal.hpp"
+#include "Mongoose_QPKernels.hpp"
+#include "Mongoose_QPNapsack.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Mongoose;
+
+/* Uniform in [lo, hi), from a fixed sequence so that every run is the same */
+double uniform(double lo, double hi)
+{
+    return lo + (hi - lo) * (std::rand() / (RAND_MAX + 1.0));
+}
+
+/* Whether two values agree to within a relative tolerance */
+bool near(double a, double b)
+{
+    return fabs(a - b) <= 1e-9 * std::max(1.0, std::max(fabs(a), fabs(b)));
+}
+
+/**
+ * Solve the napsack problem for y with both the heap-based and the
+ * selection-based search, and check that they find the same lambda and x,
+ * and that x is feasible: 0 <= x <= 1 and lo <= a'x <= hi.
+ */
+bool sameNapsack(const double *y, Int n, double lo, double hi, double *a,
+                 double Lambda = 0, const Int *FreeSet_status = NULL)
+{
+    const double tol = 1e-9;
+    size_t size      = static_cast<size_t>(n);
+    double *x1       = (double *)SuiteSparse_malloc(size, sizeof(double));
+    double *x2       = (double *)SuiteSparse_malloc(size, sizeof(double));
+    double *w        = (double *)SuiteSparse_malloc(size, sizeof(double));
+    Int *heap1       = (Int *)SuiteSparse_malloc(size + 1, sizeof(Int));
+    Int *heap2       = (Int *)SuiteSparse_malloc(size + 1, sizeof(Int));
+    if (!x1 || !x2 || !w || !heap1 || !heap2)
+    {
+        SuiteSparse_free(x1);
+        SuiteSparse_free(x2);
+        SuiteSparse_free(w);
+        SuiteSparse_free(heap1);
+        SuiteSparse_free(heap2);
+        return false;
+    }
+
+    std::copy(y, y + n, x1);
+    std::copy(y, y + n, x2);
+    double lambda1 = QPNapsack(x1, n, lo, hi, a, Lambda, FreeSet_status, w,
+                               heap1, heap2, tol, NapsackSolver_Heap);
+    double lambda2 = QPNapsack(x2, n, lo, hi, a, Lambda, FreeSet_status, w,
+                               heap1, heap2, tol, NapsackSolver_Selection);
+
+    bool same   = near(lambda1, lambda2);
+    double atx  = 0;
+    double asum = 0;
+    for (Int k = 0; k < n; k++)
+    {
+        double ak = (a) ? a[k] : 1;
+        same      = same && near(x1[k], x2[k]);
+        same      = same && (x2[k] >= 0 && x2[k] <= 1);
+        atx += ak * x2[k];
+        asum += ak;
+    }
+    same = same && (atx >= lo - tol * asum && atx <= hi + tol * asum);
+
+    SuiteSparse_free(x1);
+    SuiteSparse_free(x2);
+    SuiteSparse_free(w);
+    SuiteSparse_free(heap1);
+    SuiteSparse_free(heap2);
+    return same;
+}
+
+/**
+ * Run every QP kernel with the given instruction set and with the scalar
+ * kernels on the same inputs, and check that the results are identical.
+ * Returns the number of kernel calls that differ, or 0 if the instruction
+ * set is not supported.
+ */
+int kernelDifferences(QPKernelISA isa)
+{
+    const Int maxN = 67;
+    double x[maxN], a[maxN], D[maxN], g[maxN];
+    double y1[maxN], y2[maxN];
+    int differences = 0;
+
+    QPKernelISA active = QPKernel_getISA();
+    if (!QPKernel_setISA(isa))
+        return 0;
+
+    for (Int n = 0; n <= maxN; n++)
+    {
+        for (Int k = 0; k < n; k++)
+        {
+            x[k] = uniform(-0.5, 1.5);
+            a[k] = std::floor(uniform(1, 10)) * uniform(0.5, 1);
+            D[k] = uniform(0, 10);
+            g[k] = uniform(-1, 1);
+        }
+        double st     = uniform(-2, 2);
+        double lambda = uniform(-0.5, 0.5);
+
+        // Each kernel with isa (into y1, r1) and with scalar (y2, r2)
+        for (int kernel = 0; kernel < 5; kernel++)
+        {
+            double r1 = 0, r2 = 0;
+            for (int pass = 0; pass < 2; pass++)
+            {
+                double *y = (pass == 0) ? y1 : y2;
+                double &r = (pass == 0) ? r1 : r2;
+                QPKernel_setISA((pass == 0) ? isa : QPKernelISA_Scalar);
+                std::copy(g, g + n, y);
+                switch (kernel)
+                {
+                case 0:
+                    QPKernel_gradientInit(y, x, D, n);
+                    break;
+                case 1:
+                    QPKernel_step(y, x, st, g, n);
+                    break;
+                case 2:
+                    QPKernel_axpy(y, st, x, n);
+                    r = QPKernel_maxAbsDiff(y, x, n);
+                    break;
+                case 3:
+                    QPKernel_zero(y, n);
+                    break;
+                default:
+                    r = QPKernel_napsackSlope(x, a, lambda, n)
+                        + 2 * QPKernel_napsackSlope(x, NULL, lambda, n);
+                    break;
+                }
+            }
+            bool same = (r1 == r2);
+            for (Int k = 0; k < n; k++)
+                same = same && (y1[k] == y2[k]);
+            differences += !same;
+        }
+    }
+
+    QPKernel_setISA(active);
+    return differences;
+}
+
+int main(int argn, char **argv)
+{
+    (void)argn; // Unused variable
+    (void)argv; // Unused variable
+
+    SuiteSparse_start();
+
+    // Set Logger to report all messages and turn off timing info
+    Logger::setDebugLevel(All);
+    Logger::setTimingFlag(false);
+
+    const Int n = 200;
+    double y[n], a[n];
+    Int status[n];
+    int failures = 0;
+
+    // Random problems, with and without weights, starting from lambda = 0
+    // and from a guess based on the free set of the projection of y
+    std::srand(1);
+    for (int trial = 0; trial < 200; trial++)
+    {
+        Int m       = 1 + std::rand() % n;
+        bool weight = (trial % 2 == 1);
+        double asum = 0;
+        for (Int k = 0; k < m; k++)
+        {
+            y[k] = uniform(-2, 3);
+            a[k] = (weight) ? std::floor(uniform(1, 10)) : 1;
+            asum += a[k];
+            status[k] = (y[k] >= 1) ? 1 : (y[k] <= 0) ? -1 : 0;
+        }
+        double lo = uniform(0, 1) * asum;
+        double hi = std::min(asum, lo + uniform(0, 0.1) * asum);
+        failures += !sameNapsack(y, m, lo, hi, (weight) ? a : NULL);
+        failures += !sameNapsack(y, m, lo, hi, (weight) ? a : NULL,
+                                 uniform(-1, 1), status);
+    }
+
+    // Degenerate breakpoints: many indices leave 1 and reach 0 at the same
+    // lambda, and the solution lies exactly on such a breakpoint
+    for (Int k = 0; k < 8; k++)
+        y[k] = (k < 4) ? 1 : 0;
+    failures += !sameNapsack(y, 8, 4, 4, NULL);
+    for (Int k = 0; k < 8; k++)
+        y[k] = (k < 4) ? 1.5 : 0.5;
+    failures += !sameNapsack(y, 8, 4, 4, NULL);
+    failures += !sameNapsack(y, 8, 4, 4, NULL, 1.0, NULL);
+    for (Int k = 0; k < 8; k++)
+    {
+        y[k] = 0.5;
+        a[k] = 2;
+    }
+    failures += !sameNapsack(y, 8, 4, 4, a);
+    failures += !sameNapsack(y, 8, 6, 6, a);
+    for (Int k = 0; k < 60; k++)
+        y[k] = 0.25 * static_cast<double>(k % 5);
+    failures += !sameNapsack(y, 60, 15, 15, NULL);
+    failures += !sameNapsack(y, 60, 10, 20, NULL);
+
+    // Bounds hit: the projection of y is feasible as it is, or every x_i
+    // is pushed to the same bound
+    for (Int k = 0; k < 8; k++)
+        y[k] = 2;
+    failures += !sameNapsack(y, 8, 0, 8, NULL);
+    failures += !sameNapsack(y, 8, 8, 8, NULL);
+    failures += !sameNapsack(y, 8, 2, 2, NULL);
+    for (Int k = 0; k < 8; k++)
+        y[k] = -1;
+    failures += !sameNapsack(y, 8, 0, 0, NULL);
+    failures += !sameNapsack(y, 8, 0, 8, NULL);
+    failures += !sameNapsack(y, 8, 6, 6, NULL);
+
+    // The vector kernels must give the same results as the scalar ones,
+    // so that the partition does not depend on the CPU
+    int differences = kernelDifferences(QPKernelISA_AVX2)
+                      + kernelDifferences(QPKernelISA_AVX512);
+
+    SuiteSparse_finish();
+
+    if (failures > 0)
+    {
+        LogTest(failures << " napsack problems solved differently\n");
+        return EXIT_FAILURE;
+    }
+    if (differences > 0)
+    {
+        LogTest(differences << " kernel results differ from the scalar ones\n");
+        return EXIT_FAILURE;
+    }
+    return 0;
+}